@@ -0,0 +1,133 @@
+// Greedy vs optimal track assignment (see assignment.hpp) on synthetic
+// crossing scenes: pairs of blobs that walk through each other, either packed
+// into one crowd or spread far apart. Reports how often a ground-truth blob
+// changed its published id and the time per BlobTracker::update.
+//
+//   assignbench [frames] [noise px] [seeds]
+//
+// Not part of the application build; see CMakeLists.txt next to this file.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "blobtracker.hpp"
+#include "pipeline_settings.hpp"
+
+namespace {
+
+struct Scene {
+    const char* name;
+    int pairs;
+    float rowSpacing;   // px between the rows of neighboring pairs
+    float pairGap;      // px between the two blobs of a pair where they cross
+};
+
+// Pair k walks along row k: blob 2k left to right, blob 2k + 1 right to left,
+// passing pairGap apart in the middle of the run.
+void truth(const Scene& s, int frame, int frames, std::vector<float>& x, std::vector<float>& y) {
+    float t = frames > 1 ? static_cast<float>(frame) / (frames - 1) : 0.0f;
+    x.resize(2 * s.pairs);
+    y.resize(2 * s.pairs);
+    for (int k = 0; k < s.pairs; k++) {
+        float row = 40.0f + k * s.rowSpacing;
+        x[2 * k] = 100.0f + 200.0f * t;
+        x[2 * k + 1] = 300.0f - 200.0f * t;
+        y[2 * k] = row - 0.5f * s.pairGap;
+        y[2 * k + 1] = row + 0.5f * s.pairGap;
+    }
+}
+
+struct Result {
+    int idChanges = 0;
+    double usPerUpdate = 0.0;
+};
+
+Result run(const Scene& s, bool optimal, int frames, float noise, unsigned seed) {
+    PipelineSettings ps;
+    BlobTracker tracker;
+    tracker.setOptimalAssignment(optimal);
+    tracker.setLifecycle(ps.confirmFrames, ps.coastFrames);
+
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> jitter(0.0f, noise);
+    std::vector<float> x, y;
+    std::vector<BlobInfo> blobs;
+    std::vector<int> lastSerial(2 * s.pairs, 0);
+    Result r;
+    double totalUs = 0.0;
+
+    for (int f = 0; f < frames; f++) {
+        truth(s, f, frames, x, y);
+        blobs.assign(x.size(), BlobInfo());
+        for (size_t i = 0; i < x.size(); i++) {
+            BlobInfo& b = blobs[i];
+            b.cx = x[i] + jitter(rng);
+            b.cy = y[i] + jitter(rng);
+            b.pixelCount = 400;
+            b.avgDepthMm = 800.0f;
+        }
+        std::vector<float> measured(2 * x.size());
+        for (size_t i = 0; i < x.size(); i++) {
+            measured[2 * i] = blobs[i].cx;
+            measured[2 * i + 1] = blobs[i].cy;
+        }
+
+        auto t0 = std::chrono::steady_clock::now();
+        tracker.update(std::move(blobs), f, f * 33LL);
+        auto t1 = std::chrono::steady_clock::now();
+        totalUs += std::chrono::duration<double, std::micro>(t1 - t0).count();
+
+        // A matched track carries its detection's centroid exactly
+        for (const auto& t : tracker.activeBlobs()) {
+            if (!t.confirmed || t.misses > 0) continue;
+            for (size_t i = 0; i < x.size(); i++) {
+                if (t.centroidX != measured[2 * i] || t.centroidY != measured[2 * i + 1]) continue;
+                if (lastSerial[i] != 0 && lastSerial[i] != t.serial) r.idChanges++;
+                lastSerial[i] = t.serial;
+                break;
+            }
+        }
+    }
+    r.usPerUpdate = totalUs / frames;
+    return r;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    int frames = argc > 1 ? std::atoi(argv[1]) : 60;
+    float noise = argc > 2 ? static_cast<float>(std::atof(argv[2])) : 2.0f;
+    int seeds = argc > 3 ? std::atoi(argv[3]) : 5;
+    if (frames < 2) frames = 2;
+    if (seeds < 1) seeds = 1;
+
+    const Scene scenes[] = {
+        {"crowd 30 pairs", 30, 24.0f, 8.0f},
+        {"crowd 10 pairs", 10, 24.0f, 8.0f},
+        {"isolated 10 pairs", 10, 200.0f, 8.0f},
+        {"isolated 2 pairs", 2, 200.0f, 8.0f},
+    };
+
+    std::printf("%d frames, %.1f px noise, %d seeds; id changes and us per update (min-max)\n",
+                frames, noise, seeds);
+    std::printf("%-20s %-9s %14s %18s\n", "scene", "mode", "id changes", "us/update");
+    for (const Scene& s : scenes) {
+        for (int optimal = 0; optimal <= 1; optimal++) {
+            int minChanges = 0, maxChanges = 0;
+            double minUs = 0.0, maxUs = 0.0;
+            for (int k = 0; k < seeds; k++) {
+                Result r = run(s, optimal != 0, frames, noise, 1000u + k);
+                if (k == 0 || r.idChanges < minChanges) minChanges = r.idChanges;
+                if (k == 0 || r.idChanges > maxChanges) maxChanges = r.idChanges;
+                if (k == 0 || r.usPerUpdate < minUs) minUs = r.usPerUpdate;
+                if (k == 0 || r.usPerUpdate > maxUs) maxUs = r.usPerUpdate;
+            }
+            std::printf("%-20s %-9s %6d - %-6d %8.1f - %-8.1f\n", s.name, optimal ? "optimal" : "greedy",
+                        minChanges, maxChanges, minUs, maxUs);
+        }
+    }
+    return 0;
+}
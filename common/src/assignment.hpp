@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Globally optimal one-to-one assignment over a sparse set of candidate pairs
+// (e.g. tracked blobs x detections within the match radius). Minimizes the
+// summed cost of the chosen pairs plus unmatchedCost for every element left
+// unassigned on either side, so a pair is only dropped when that is cheaper.
+//
+// The candidate graph usually falls apart into small groups (two hands
+// crossing, a cluster of balls): the pairs are split into connected components
+// and each one is solved with a dense Hungarian (Kuhn-Munkres, O(k^3)) on a
+// k = (actives + detections) square matrix padded with "unmatched" slots.
+// Isolated pairs skip the solver entirely.
+struct AssignEdge {
+    int a, b;       // index on each side
+    int cost;       // >= 0
+};
+
+class SparseAssignment {
+public:
+    // matchA[a] receives the b assigned to a, or -1. Edges with cost >= 2 *
+    // unmatchedCost can never win and may be left out by the caller.
+    void solve(int na, int nb, const std::vector<AssignEdge>& edges, int unmatchedCost,
+               std::vector<int>& matchA) {
+        matchA.assign(na, -1);
+        if (edges.empty()) return;
+
+        // Components over na + nb nodes (b nodes offset by na)
+        parent_.resize(na + nb);
+        for (int i = 0; i < na + nb; i++) parent_[i] = i;
+        for (const auto& e : edges) unite(e.a, na + e.b);
+
+        // Group edges by component root (counting sort)
+        compStart_.assign(na + nb + 1, 0);
+        for (const auto& e : edges) compStart_[find(e.a) + 1]++;
+        for (int i = 0; i < na + nb; i++) compStart_[i + 1] += compStart_[i];
+        fill_.assign(compStart_.begin(), compStart_.end() - 1);
+        byComp_.resize(edges.size());
+        for (const auto& e : edges) byComp_[fill_[find(e.a)]++] = e;
+
+        localA_.assign(na, -1);
+        localB_.assign(nb, -1);
+        for (int root = 0; root < na + nb; root++) {
+            int begin = compStart_[root], end = compStart_[root + 1];
+            if (begin == end) continue;
+            if (end - begin == 1) {
+                matchA[byComp_[begin].a] = byComp_[begin].b;   // a lone pair always matches
+                continue;
+            }
+            solveComponent(begin, end, unmatchedCost, matchA);
+        }
+    }
+
+private:
+    int find(int x) {
+        while (parent_[x] != x) x = parent_[x] = parent_[parent_[x]];
+        return x;
+    }
+
+    void unite(int x, int y) {
+        x = find(x);
+        y = find(y);
+        if (x != y) parent_[y] = x;
+    }
+
+    void solveComponent(int begin, int end, int unmatchedCost, std::vector<int>& matchA) {
+        // Local numbering of this component's nodes
+        as_.clear();
+        bs_.clear();
+        for (int i = begin; i < end; i++) {
+            const auto& e = byComp_[i];
+            if (localA_[e.a] < 0) { localA_[e.a] = static_cast<int>(as_.size()); as_.push_back(e.a); }
+            if (localB_[e.b] < 0) { localB_[e.b] = static_cast<int>(bs_.size()); bs_.push_back(e.b); }
+        }
+        int ka = static_cast<int>(as_.size()), kb = static_cast<int>(bs_.size());
+        int n = ka + kb;
+
+        // Rows: ka actives then kb "detection unmatched" slots.
+        // Cols: kb detections then ka "active unmatched" slots.
+        const int64_t inf = static_cast<int64_t>(1) << 40;
+        cost_.assign(static_cast<size_t>(n) * n, inf);
+        auto at = [&](int r, int c) -> int64_t& { return cost_[static_cast<size_t>(r) * n + c]; };
+        for (int i = begin; i < end; i++) {
+            const auto& e = byComp_[i];
+            at(localA_[e.a], localB_[e.b]) = e.cost;
+        }
+        for (int i = 0; i < ka; i++) at(i, kb + i) = unmatchedCost;
+        for (int j = 0; j < kb; j++) at(ka + j, j) = unmatchedCost;
+        for (int r = ka; r < n; r++)
+            for (int c = kb; c < n; c++) at(r, c) = 0;
+
+        hungarian(n);
+        for (int c = 1; c <= n; c++) {
+            int r = p_[c] - 1;
+            if (r < ka && c - 1 < kb && at(r, c - 1) < inf) matchA[as_[r]] = bs_[c - 1];
+        }
+        for (int a : as_) localA_[a] = -1;
+        for (int b : bs_) localB_[b] = -1;
+    }
+
+    // Shortest augmenting path Hungarian with potentials on the n x n cost_
+    // matrix; p_[col] (1-based) receives the row assigned to each column.
+    void hungarian(int n) {
+        const int64_t inf = static_cast<int64_t>(1) << 60;
+        u_.assign(n + 1, 0);
+        v_.assign(n + 1, 0);
+        p_.assign(n + 1, 0);
+        way_.assign(n + 1, 0);
+        for (int i = 1; i <= n; i++) {
+            p_[0] = i;
+            int j0 = 0;
+            minv_.assign(n + 1, inf);
+            used_.assign(n + 1, 0);
+            do {
+                used_[j0] = 1;
+                int i0 = p_[j0], j1 = 0;
+                int64_t delta = inf;
+                for (int j = 1; j <= n; j++) {
+                    if (used_[j]) continue;
+                    int64_t cur = cost_[static_cast<size_t>(i0 - 1) * n + (j - 1)] - u_[i0] - v_[j];
+                    if (cur < minv_[j]) { minv_[j] = cur; way_[j] = j0; }
+                    if (minv_[j] < delta) { delta = minv_[j]; j1 = j; }
+                }
+                for (int j = 0; j <= n; j++) {
+                    if (used_[j]) { u_[p_[j]] += delta; v_[j] -= delta; }
+                    else minv_[j] -= delta;
+                }
+                j0 = j1;
+            } while (p_[j0] != 0);
+            do {
+                int j1 = way_[j0];
+                p_[j0] = p_[j1];
+                j0 = j1;
+            } while (j0);
+        }
+    }
+
+    std::vector<int> parent_, compStart_, fill_;
+    std::vector<AssignEdge> byComp_;
+    std::vector<int> localA_, localB_, as_, bs_;
+    std::vector<int64_t> cost_, u_, v_, minv_;
+    std::vector<int> p_, way_;
+    std::vector<uint8_t> used_;
+};
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "roimask.hpp"
+
+// Multi-band segmentation: several depth bands (e.g. "hover" 400-550 mm and
+// "touch" 550-700 mm) are classified from the same frame. Each pixel gets a
+// band id (1..count, 0 = none) through a 64K-entry depth lookup table built
+// once per config change, so classification is a single table lookup per pixel.
+// Labeling then only connects pixels of the same band, and every band has its
+// own tracker / id space.
+//
+// Spec format: "near-far, near-far, ..." in mm, e.g. "400-550, 550-700".
+// Where bands overlap the earlier one wins.
+
+constexpr int kMaxBands = 8;
+
+struct DepthBands {
+    int count = 0;                          // configured bands (ids 1..count)
+    uint16_t nearMm[kMaxBands + 1] = {};
+    uint16_t farMm[kMaxBands + 1] = {};
+    std::vector<uint8_t> lut;               // depth (mm) -> band id, 65536 entries
+};
+
+// Keep only characters valid in a band spec.
+inline std::string sanitizeBandSpec(const std::string& text) {
+    std::string out;
+    out.reserve(text.size());
+    for (char c : text) {
+        if ((c >= '0' && c <= '9') || c == ',' || c == ' ' || c == '-') out += c;
+    }
+    return out;
+}
+
+// Parse the spec and build the lookup table. count == 0 when disabled or empty.
+inline void compileDepthBands(DepthBands& bands, bool enabled, const std::string& spec) {
+    bands.count = 0;
+    bands.lut.assign(65536, 0);
+    if (!enabled) return;
+
+    const char* p = spec.c_str();
+    while (*p && bands.count < kMaxBands) {
+        while (*p == ' ' || *p == ',') p++;
+        if (!*p) break;
+        char* end = nullptr;
+        long nearMm = std::strtol(p, &end, 10);
+        if (end == p) { p++; continue; }
+        p = end;
+        while (*p == ' ') p++;
+        if (*p != '-') continue;
+        p++;
+        long farMm = std::strtol(p, &end, 10);
+        if (end == p) continue;
+        p = end;
+
+        if (nearMm < 1) nearMm = 1;
+        if (farMm > 65535) farMm = 65535;
+        if (farMm <= nearMm) continue;
+        int id = ++bands.count;
+        bands.nearMm[id] = static_cast<uint16_t>(nearMm);
+        bands.farMm[id] = static_cast<uint16_t>(farMm);
+    }
+
+    // Fill in reverse so earlier bands overwrite later ones where they overlap
+    for (int id = bands.count; id >= 1; id--)
+        std::memset(bands.lut.data() + bands.nearMm[id], id, bands.farMm[id] - bands.nearMm[id]);
+}
+
+// Classify depth into bands in one pass: writes the band id map and a
+// black/white mask (black = pixel in any band) for labeling and display.
+// If roi is given (and not full-frame), only the active spans are visited.
+inline void depthToBandsBgr(const uint16_t* depthMm, int width, int height, uint8_t* outBgr,
+                            const DepthBands& bands, uint8_t* bandMap,
+                            const RoiSpans* roi = nullptr) {
+    const uint8_t* lut = bands.lut.data();
+    auto classifyPixel = [&](int i) {
+        uint8_t id = lut[depthMm[i]];
+        uint8_t v = id ? 0 : 255;
+        bandMap[i] = id;
+        outBgr[i * 3 + 0] = v;
+        outBgr[i * 3 + 1] = v;
+        outBgr[i * 3 + 2] = v;
+    };
+
+    if (!roi || roi->full) {
+        int total = width * height;
+        for (int i = 0; i < total; i++) classifyPixel(i);
+        return;
+    }
+
+    std::memset(outBgr, 255, static_cast<size_t>(width) * height * 3);
+    std::memset(bandMap, 0, static_cast<size_t>(width) * height);
+    for (int y = 0; y < height; y++) {
+        for (int s = roi->rowBegin(y); s < roi->rowEnd(y); s++) {
+            const Span& sp = roi->spans[s];
+            for (int i = y * width + sp.x0; i < y * width + sp.x1; i++) classifyPixel(i);
+        }
+    }
+}
@@ -1,8 +1,16 @@
 #pragma once
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <vector>
 
+#include "contour.hpp"
+#include "depthhist.hpp"
+#include "hull.hpp"
+#include "depthcolor.hpp"
+#include "roimask.hpp"
+
 // Simple union-find (disjoint set) for connected component labeling.
 struct UnionFind {
     std::vector<int> parent;
@@ -43,108 +51,210 @@ struct UnionFind {
 };
 
 struct BlobInfo {
-    int minX, minY, maxX, maxY;
-    int pixelCount;
-    uint64_t depthSum;      // accumulator for average calculation
-    float avgDepthMm;       // average depth across blob pixels
-    uint16_t maxDepthMm;    // maximum depth in this blob
-    int maxDepthX, maxDepthY; // pixel position of the maximum depth
+    int minX = 0, minY = 0, maxX = 0, maxY = 0;
+    int pixelCount = 0;
+    uint64_t depthSum = 0;  // accumulator for average calculation
+    float avgDepthMm = 0.0f;  // average depth across blob pixels
+    uint16_t maxDepthMm = 0;  // maximum depth in this blob
+    int maxDepthX = 0, maxDepthY = 0;  // pixel position of the maximum depth
+    int zone = 0;           // zone id when labeled with a zone map (see zones.hpp)
+    int band = 0;           // depth band id when labeled with a band map (see bands.hpp)
+    int label = 0;          // resolved label in the label buffer
+    int startX = 0, startY = 0;            // first pixel in raster order (contour start)
+
+    // Raw moments accumulated while labeling (m00 is pixelCount)
+    uint64_t m10 = 0, m01 = 0, m11 = 0, m20 = 0, m02 = 0;
+    uint64_t dm10 = 0, dm01 = 0;           // depth-weighted m10 / m01 (m00 is depthSum)
+
+    // Derived in finishBlobMoments
+    float cx = 0.0f, cy = 0.0f;            // sub-pixel centroid
+    float depthCx = 0.0f, depthCy = 0.0f;  // depth-weighted centroid (= cx, cy without depth)
+    float angleDeg = 0.0f;                 // principal axis, -90..90, 0 = along x
+    float eccentricity = 0.0f;             // 0 = round, towards 1 = elongated
+
+    // Depth distribution of the valid (non-zero) depth pixels
+    DepthHistogram depthHist;
+    uint16_t minDepthMm = 0;               // nearest valid depth, 0 = none
+    int minDepthX = 0, minDepthY = 0;      // pixel position of the nearest depth
+    float p10Mm = 0.0f, medianMm = 0.0f, p90Mm = 0.0f;   // derived in finishBlobDepth
+
+    // Camera-space position (mm), filled in by DepthRays (deproject.hpp)
+    float xMm = 0.0f, yMm = 0.0f, zMm = 0.0f;
+
+    // Filled in by BlobShapeAnalyzer (blobshape.hpp)
+    std::vector<ContourPoint> contour;     // simplified outline
+    std::vector<BlobTip> tips;             // extremities, farthest from the centroid first
+    int defects = 0;                       // number of significant convexity defects
+
+    // Mean color of the blob's pixels visible to the color camera, filled in
+    // by DepthColorRegistration::sampleBlobColors (registration.hpp) in color mode
+    uint8_t colorB = 0, colorG = 0, colorR = 0;
+    bool hasColor = false;
 };
 
-// Detect connected components of black pixels (val == 0) in a packed BGR image,
-// then draw green rectangles around blobs whose pixel count <= maxBlobPixels.
-// Operates in-place on the BGR buffer.
-// If depthMm is provided, computes per-blob depth statistics.
-// Returns the filtered blobs (those that were drawn).
-inline std::vector<BlobInfo> detectAndDrawBlobs(uint8_t* bgr, int width, int height,
-                                                 int maxBlobPixels,
-                                                 const uint16_t* depthMm = nullptr,
-                                                 int minBlobPixels = 20) {
-    int totalPixels = width * height;
+// An empty blob whose first pixel in raster order is (x, y); stats are added
+// with accumulateBlobPixel.
+inline BlobInfo startBlob(int x, int y, int label, int zone, int band) {
+    BlobInfo b;
+    b.minX = b.maxX = b.startX = x;
+    b.minY = b.maxY = b.startY = y;
+    b.label = label;
+    b.zone = zone;
+    b.band = band;
+    return b;
+}
 
-    // Label buffer — 0 means unlabeled / background (white pixel)
-    std::vector<int> labels(totalPixels, 0);
+// Centroid, orientation and eccentricity from the accumulated raw moments.
+// The principal axes are the eigenvectors of the second central moments.
+inline void finishBlobMoments(BlobInfo& b) {
+    if (b.pixelCount <= 0) return;
+    double n = static_cast<double>(b.pixelCount);
+    double cx = b.m10 / n, cy = b.m01 / n;
+    b.cx = static_cast<float>(cx);
+    b.cy = static_cast<float>(cy);
+    b.depthCx = b.cx;
+    b.depthCy = b.cy;
+    if (b.depthSum > 0) {
+        b.depthCx = static_cast<float>(static_cast<double>(b.dm10) / b.depthSum);
+        b.depthCy = static_cast<float>(static_cast<double>(b.dm01) / b.depthSum);
+    }
 
-    UnionFind uf;
-    // Index 0 = dummy (reserved for "no label"). Labels start at 1.
-    uf.grow(0);
+    double mu20 = b.m20 / n - cx * cx;
+    double mu02 = b.m02 / n - cy * cy;
+    double mu11 = b.m11 / n - cx * cy;
+    b.angleDeg = static_cast<float>(0.5 * std::atan2(2.0 * mu11, mu20 - mu02) * 180.0 / 3.14159265358979);
+    double common = std::sqrt(4.0 * mu11 * mu11 + (mu20 - mu02) * (mu20 - mu02));
+    double major = 0.5 * (mu20 + mu02 + common);
+    double minor = 0.5 * (mu20 + mu02 - common);
+    b.eccentricity = (major > 0.0 && minor >= 0.0)
+                         ? static_cast<float>(std::sqrt(1.0 - minor / major)) : 0.0f;
+}
 
-    int nextLabel = 1;
+// Robust depth figures from the blob's depth histogram: the median and the
+// 10th / 90th percentiles ignore the few flying pixels along the edges that
+// skew the average and the extremes.
+inline void finishBlobDepth(BlobInfo& b) {
+    if (b.depthHist.total == 0) return;
+    b.p10Mm = b.depthHist.percentile(0.1f);
+    b.medianMm = b.depthHist.percentile(0.5f);
+    b.p90Mm = b.depthHist.percentile(0.9f);
+}
 
-    // ---- Pass 1: assign provisional labels ----
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            int idx = y * width + x;
-            // Check if this pixel is black (foreground)
-            int bgrIdx = idx * 3;
-            if (bgr[bgrIdx] != 0 || bgr[bgrIdx + 1] != 0 || bgr[bgrIdx + 2] != 0)
-                continue;  // white/non-black -> background
-
-            int labelUp   = (y > 0) ? labels[(y - 1) * width + x] : 0;
-            int labelLeft  = (x > 0) ? labels[y * width + (x - 1)] : 0;
-
-            if (labelUp == 0 && labelLeft == 0) {
-                // New component
-                uf.grow(nextLabel);
-                labels[idx] = nextLabel;
-                nextLabel++;
-            } else if (labelUp != 0 && labelLeft == 0) {
-                labels[idx] = labelUp;
-            } else if (labelUp == 0 && labelLeft != 0) {
-                labels[idx] = labelLeft;
-            } else {
-                // Both neighbors labeled — pick one, merge
-                labels[idx] = labelUp;
-                uf.unite(labelUp, labelLeft);
+// Add pixel (x, y) to a blob's bounding box, depth stats and raw moments.
+inline void accumulateBlobPixel(BlobInfo& b, int x, int y, int idx, const uint16_t* depthMm) {
+    if (x < b.minX) b.minX = x;
+    if (x > b.maxX) b.maxX = x;
+    if (y < b.minY) b.minY = y;
+    if (y > b.maxY) b.maxY = y;
+    b.pixelCount++;
+    b.m10 += x;
+    b.m01 += y;
+    b.m11 += static_cast<uint64_t>(x) * y;
+    b.m20 += static_cast<uint64_t>(x) * x;
+    b.m02 += static_cast<uint64_t>(y) * y;
+
+    if (depthMm) {
+        uint16_t d = depthMm[idx];
+        b.depthSum += d;
+        b.dm10 += static_cast<uint64_t>(d) * x;
+        b.dm01 += static_cast<uint64_t>(d) * y;
+        if (d > b.maxDepthMm) {
+            b.maxDepthMm = d;
+            b.maxDepthX = x;
+            b.maxDepthY = y;
+        }
+        if (d) {
+            b.depthHist.add(d);
+            if (!b.minDepthMm || d < b.minDepthMm) {
+                b.minDepthMm = d;
+                b.minDepthX = x;
+                b.minDepthY = y;
             }
         }
     }
+}
 
-    if (nextLabel <= 1) return {};  // no foreground pixels at all
-
-    // ---- Pass 2: resolve labels, compute bounding boxes and depth stats ----
-    std::vector<int> rootToBlob(nextLabel, -1);
-    std::vector<BlobInfo> blobs;
+// Combine the raw stats of two parts of the same component (e.g. per-tile
+// summaries, see tilelabel.hpp). The start pixel stays the first in raster order.
+inline void mergeBlobStats(BlobInfo& into, const BlobInfo& from) {
+    if (from.minX < into.minX) into.minX = from.minX;
+    if (from.maxX > into.maxX) into.maxX = from.maxX;
+    if (from.minY < into.minY) into.minY = from.minY;
+    if (from.maxY > into.maxY) into.maxY = from.maxY;
+    into.pixelCount += from.pixelCount;
+    into.depthSum += from.depthSum;
+    into.m10 += from.m10;
+    into.m01 += from.m01;
+    into.m11 += from.m11;
+    into.m20 += from.m20;
+    into.m02 += from.m02;
+    into.dm10 += from.dm10;
+    into.dm01 += from.dm01;
+    if (from.maxDepthMm > into.maxDepthMm) {
+        into.maxDepthMm = from.maxDepthMm;
+        into.maxDepthX = from.maxDepthX;
+        into.maxDepthY = from.maxDepthY;
+    }
+    if (from.minDepthMm && (!into.minDepthMm || from.minDepthMm < into.minDepthMm)) {
+        into.minDepthMm = from.minDepthMm;
+        into.minDepthX = from.minDepthX;
+        into.minDepthY = from.minDepthY;
+    }
+    into.depthHist.merge(from.depthHist);
+    if (from.startY < into.startY || (from.startY == into.startY && from.startX < into.startX)) {
+        into.startX = from.startX;
+        into.startY = from.startY;
+    }
+}
 
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            int idx = y * width + x;
-            int lbl = labels[idx];
-            if (lbl == 0) continue;
+// Split an (oversized) blob along depth discontinuities: inside its bounding
+// box, its pixels are re-labeled so that 4-neighbors only connect when both
+// have valid depth within stepMm of each other. Two bodies touching in the
+// mask but at different depths (people side by side, a hand resting on an
+// object) come apart this way. Sub-blobs get fresh labels (from nextLabel,
+// written to labels) and their own stats, appended to out; the cost is
+// confined to the parent's bounding box. stack is a scratch buffer.
+inline void splitBlobByDepth(const BlobInfo& parent, std::vector<int>& labels, int width,
+                             const uint16_t* depthMm, int stepMm, int& nextLabel,
+                             std::vector<BlobInfo>& out, std::vector<int>& stack) {
+    auto connects = [&](int a, int b) {
+        int da = depthMm[a], db = depthMm[b];
+        return da && db && (da > db ? da - db : db - da) <= stepMm;
+    };
 
-            int root = uf.find(lbl);
-            labels[idx] = root;
+    for (int y = parent.minY; y <= parent.maxY; y++) {
+        for (int x = parent.minX; x <= parent.maxX; x++) {
+            int seed = y * width + x;
+            if (labels[seed] != parent.label) continue;
 
-            int blobIdx = rootToBlob[root];
-            if (blobIdx < 0) {
-                blobIdx = static_cast<int>(blobs.size());
-                rootToBlob[root] = blobIdx;
-                blobs.push_back({x, y, x, y, 0, 0, 0.0f, 0, 0, 0});
-            }
+            // Raster order: the seed is the first pixel of its sub-blob (contour start)
+            int lbl = nextLabel++;
+            BlobInfo b = startBlob(x, y, lbl, parent.zone, parent.band);
+            labels[seed] = lbl;
+            stack.clear();
+            stack.push_back(seed);
+            while (!stack.empty()) {
+                int idx = stack.back();
+                stack.pop_back();
+                int px = idx % width, py = idx / width;
+                accumulateBlobPixel(b, px, py, idx, depthMm);
 
-            BlobInfo& b = blobs[blobIdx];
-            if (x < b.minX) b.minX = x;
-            if (x > b.maxX) b.maxX = x;
-            if (y < b.minY) b.minY = y;
-            if (y > b.maxY) b.maxY = y;
-            b.pixelCount++;
-
-            if (depthMm) {
-                uint16_t d = depthMm[idx];
-                b.depthSum += d;
-                if (d > b.maxDepthMm) {
-                    b.maxDepthMm = d;
-                    b.maxDepthX = x;
-                    b.maxDepthY = y;
+                int nbr[4] = {idx - 1, idx + 1, idx - width, idx + width};
+                bool ok[4] = {px > parent.minX, px < parent.maxX, py > parent.minY, py < parent.maxY};
+                for (int k = 0; k < 4; k++) {
+                    if (!ok[k] || labels[nbr[k]] != parent.label || !connects(idx, nbr[k])) continue;
+                    labels[nbr[k]] = lbl;
+                    stack.push_back(nbr[k]);
                 }
             }
+            out.push_back(b);
         }
     }
+}
 
-    // ---- Filter, compute averages, draw rectangles ----
-    std::vector<BlobInfo> result;
-    // minBlobPixels is now a function parameter (default 20)
-
+// Draw a blob's bounding box into a BGR image: a 2px thick green rectangle
+// with a 2px margin for visibility.
+inline void drawBlobRect(uint8_t* bgr, int width, int height, const BlobInfo& b) {
     auto drawHLine = [&](int x0, int x1, int y) {
         if (y < 0 || y >= height) return;
         if (x0 < 0) x0 = 0;
@@ -169,31 +279,276 @@ inline std::vector<BlobInfo> detectAndDrawBlobs(uint8_t* bgr, int width, int hei
         }
     };
 
-    for (auto& b : blobs) {
-        if (b.pixelCount < minBlobPixels) continue;   // skip noise
-        if (b.pixelCount > maxBlobPixels) continue;    // skip large blobs
+    int rx0 = b.minX - 2;
+    int ry0 = b.minY - 2;
+    int rx1 = b.maxX + 2;
+    int ry1 = b.maxY + 2;
+    drawHLine(rx0, rx1, ry0);
+    drawHLine(rx0, rx1, ry1);
+    drawVLine(rx0, ry0, ry1);
+    drawVLine(rx1, ry0, ry1);
+    drawHLine(rx0 + 1, rx1 - 1, ry0 + 1);
+    drawHLine(rx0 + 1, rx1 - 1, ry1 - 1);
+    drawVLine(rx0 + 1, ry0 + 1, ry1 - 1);
+    drawVLine(rx1 - 1, ry0 + 1, ry1 - 1);
+}
+
+// Final stage of labeling, shared by detectAndDrawBlobs and IncrementalLabeler
+// (tilelabel.hpp): split oversized blobs, drop those outside the size limits,
+// select the top maxBlobs, finish their stats and draw their rectangles.
+// blobs hold raw accumulated stats; labels / nextLabel are only used for splitting.
+inline std::vector<BlobInfo> selectAndDrawBlobs(uint8_t* bgr, int width, int height,
+                                                 std::vector<BlobInfo>& blobs,
+                                                 std::vector<int>& labels, int& nextLabel,
+                                                 int maxBlobPixels, const uint16_t* depthMm,
+                                                 int minBlobPixels, int splitStepMm,
+                                                 int maxBlobs, bool nearestFirst) {
+    std::vector<BlobInfo> result;
+
+    std::vector<BlobInfo> parts;
+    std::vector<int> fillStack;
+    if (splitStepMm > 0 && depthMm) {
+        for (const auto& b : blobs) {
+            if (b.pixelCount > maxBlobPixels)
+                splitBlobByDepth(b, labels, width, depthMm, splitStepMm, nextLabel, parts, fillStack);
+        }
+    }
+
+    // Rank: true if a should be kept over b
+    bool byDepth = nearestFirst && depthMm;
+    auto better = [byDepth](const BlobInfo* a, const BlobInfo* b) {
+        return byDepth ? a->avgDepthMm < b->avgDepthMm : a->pixelCount > b->pixelCount;
+    };
+
+    // Qualifying blobs; with a limit, a heap of the best maxBlobs with the worst on top
+    std::vector<BlobInfo*> kept;
+    if (maxBlobs > 0) kept.reserve(maxBlobs + 1);
+    auto consider = [&](BlobInfo& b) {
+        if (b.pixelCount < minBlobPixels) return;   // skip noise
+        if (b.pixelCount > maxBlobPixels) return;    // skip large blobs
 
         // Compute average depth
         if (depthMm && b.pixelCount > 0) {
             b.avgDepthMm = static_cast<float>(b.depthSum) / b.pixelCount;
         }
+        kept.push_back(&b);
+        if (maxBlobs <= 0) return;
+        std::push_heap(kept.begin(), kept.end(), better);
+        if (static_cast<int>(kept.size()) > maxBlobs) {
+            std::pop_heap(kept.begin(), kept.end(), better);
+            kept.pop_back();
+        }
+    };
+    for (auto& b : blobs) consider(b);
+    for (auto& b : parts) consider(b);
+    if (maxBlobs > 0) std::sort_heap(kept.begin(), kept.end(), better);
 
-        // Draw 2px thick rectangle with 2px margin for visibility
-        int rx0 = b.minX - 2;
-        int ry0 = b.minY - 2;
-        int rx1 = b.maxX + 2;
-        int ry1 = b.maxY + 2;
-        drawHLine(rx0, rx1, ry0);
-        drawHLine(rx0, rx1, ry1);
-        drawVLine(rx0, ry0, ry1);
-        drawVLine(rx1, ry0, ry1);
-        drawHLine(rx0 + 1, rx1 - 1, ry0 + 1);
-        drawHLine(rx0 + 1, rx1 - 1, ry1 - 1);
-        drawVLine(rx0 + 1, ry0 + 1, ry1 - 1);
-        drawVLine(rx1 - 1, ry0 + 1, ry1 - 1);
-
-        result.push_back(b);
+    result.reserve(kept.size());
+    for (BlobInfo* b : kept) {
+        finishBlobMoments(*b);
+        finishBlobDepth(*b);
+        drawBlobRect(bgr, width, height, *b);
+        result.push_back(std::move(*b));
     }
-
     return result;
 }
+
+// Labeling storage, kept between frames by detectAndDrawBlobs
+struct BlobLabelScratch {
+    std::vector<int> labels;           // used when the caller passes no label buffer
+    UnionFind uf;
+    std::vector<uint8_t> labelStrong;  // per provisional label: contains a black pixel
+    std::vector<int> labelCount;       // pixels per provisional label, then per root
+    std::vector<uint8_t> rootStrong;
+    std::vector<int> rootToBlob;       // -1 = not seen yet, -2 = outside the size limits
+    std::vector<BlobInfo> blobs;
+};
+
+// Detect connected components of black pixels (val == 0) in a packed BGR image,
+// then draw green rectangles around blobs whose pixel count <= maxBlobPixels.
+// Operates in-place on the BGR buffer.
+// Weak foreground (kWeakForeground gray, from the hysteresis threshold) is
+// labeled together with black pixels; components without any black pixel are
+// dropped and repainted white, the weak pixels of kept ones are painted black.
+// If depthMm is provided, computes per-blob depth statistics (average, extremes
+// and, from a per-blob histogram, median and 10th / 90th percentiles).
+// Raw (and depth-weighted) moments are accumulated in the same pass and turned
+// into centroid / orientation / eccentricity for the kept blobs.
+// If splitStepMm > 0 (and depthMm is given), blobs larger than maxBlobPixels
+// are split along depth steps larger than that (splitBlobByDepth) instead of
+// being dropped; the resulting parts are filtered like any other blob.
+// Pixels are counted per component in the first pass, so only components
+// within [minBlobPixels, maxBlobPixels] get a BlobInfo with full stats;
+// oversized ones that may be split only track their bounding box, and specks
+// cost nothing beyond their labels.
+// If maxBlobs > 0, only the maxBlobs largest (or, with nearestFirst, nearest by
+// average depth) qualifying blobs are kept, best first, via a bounded heap.
+// If roi is provided, only pixels inside its active spans are labeled.
+// If zoneMap is provided (one zone id per pixel), neighbors only connect when
+// they share a zone, so every blob lies within a single zone. bandMap works the
+// same way for depth bands (see bands.hpp).
+// If labelBuffer is provided it is used (and reused across calls) as the label
+// image, and holds each kept pixel's BlobInfo::label on return.
+// Returns the filtered blobs (those that were drawn).
+inline std::vector<BlobInfo> detectAndDrawBlobs(uint8_t* bgr, int width, int height,
+                                                 int maxBlobPixels,
+                                                 const uint16_t* depthMm = nullptr,
+                                                 int minBlobPixels = 20,
+                                                 const RoiSpans* roi = nullptr,
+                                                 const uint8_t* zoneMap = nullptr,
+                                                 const uint8_t* bandMap = nullptr,
+                                                 std::vector<int>* labelBuffer = nullptr,
+                                                 int splitStepMm = 0,
+                                                 int maxBlobs = 0,
+                                                 bool nearestFirst = false) {
+    int totalPixels = width * height;
+    bool useSpans = roi && !roi->full;
+
+    // Visit every active pixel in raster order (whole frame, or ROI spans only)
+    auto forEachActive = [&](auto&& fn) {
+        if (!useSpans) {
+            for (int y = 0; y < height; y++)
+                for (int x = 0; x < width; x++) fn(x, y);
+            return;
+        }
+        for (int y = 0; y < height; y++) {
+            for (int s = roi->rowBegin(y); s < roi->rowEnd(y); s++) {
+                const Span& sp = roi->spans[s];
+                for (int x = sp.x0; x < sp.x1; x++) fn(x, y);
+            }
+        }
+    };
+
+    thread_local BlobLabelScratch scratch;
+
+    // Label buffer — 0 means unlabeled / background (white pixel)
+    std::vector<int>& labels = labelBuffer ? *labelBuffer : scratch.labels;
+    labels.assign(totalPixels, 0);
+
+    UnionFind& uf = scratch.uf;
+    // Index 0 = dummy (reserved for "no label"). Labels start at 1.
+    uf.parent.clear();
+    uf.rank.clear();
+    uf.grow(0);
+
+    int nextLabel = 1;
+    std::vector<uint8_t>& labelStrong = scratch.labelStrong;
+    std::vector<int>& labelCount = scratch.labelCount;
+    labelStrong.assign(1, 0);
+    labelCount.assign(1, 0);
+    bool sawWeak = false;
+
+    // ---- Pass 1: assign provisional labels ----
+    forEachActive([&](int x, int y) {
+        int idx = y * width + x;
+        // Check if this pixel is black (foreground)
+        int bgrIdx = idx * 3;
+        uint8_t v = bgr[bgrIdx];
+        if ((v != 0 && v != kWeakForeground) || bgr[bgrIdx + 1] != v || bgr[bgrIdx + 2] != v)
+            return;  // white/non-black -> background
+        bool strong = (v == 0);
+        if (!strong) sawWeak = true;
+
+        int labelUp   = (y > 0) ? labels[(y - 1) * width + x] : 0;
+        int labelLeft  = (x > 0) ? labels[y * width + (x - 1)] : 0;
+        if (zoneMap) {
+            if (labelUp && zoneMap[idx - width] != zoneMap[idx]) labelUp = 0;
+            if (labelLeft && zoneMap[idx - 1] != zoneMap[idx]) labelLeft = 0;
+        }
+        if (bandMap) {
+            if (labelUp && bandMap[idx - width] != bandMap[idx]) labelUp = 0;
+            if (labelLeft && bandMap[idx - 1] != bandMap[idx]) labelLeft = 0;
+        }
+
+        if (labelUp == 0 && labelLeft == 0) {
+            // New component
+            uf.grow(nextLabel);
+            labelStrong.push_back(0);
+            labelCount.push_back(0);
+            labels[idx] = nextLabel;
+            nextLabel++;
+        } else if (labelUp != 0 && labelLeft == 0) {
+            labels[idx] = labelUp;
+        } else if (labelUp == 0 && labelLeft != 0) {
+            labels[idx] = labelLeft;
+        } else {
+            // Both neighbors labeled — pick one, merge
+            labels[idx] = labelUp;
+            uf.unite(labelUp, labelLeft);
+        }
+        if (strong) labelStrong[labels[idx]] = 1;
+        labelCount[labels[idx]]++;
+    });
+
+    if (nextLabel <= 1) return {};  // no foreground pixels at all
+
+    // Component sizes: fold the label counts into their roots
+    for (int l = 1; l < nextLabel; l++) {
+        int root = uf.find(l);
+        if (root != l) labelCount[root] += labelCount[l];
+    }
+
+    // Hysteresis: a component survives only if one of its labels saw a strong pixel
+    std::vector<uint8_t>& rootStrong = scratch.rootStrong;
+    if (sawWeak) {
+        rootStrong.assign(nextLabel, 0);
+        for (int l = 1; l < nextLabel; l++)
+            if (labelStrong[l]) rootStrong[uf.find(l)] = 1;
+    }
+
+    // ---- Pass 2: resolve labels, compute bounding boxes and depth stats ----
+    std::vector<int>& rootToBlob = scratch.rootToBlob;
+    std::vector<BlobInfo>& blobs = scratch.blobs;
+    rootToBlob.assign(nextLabel, -1);
+    blobs.clear();
+    bool canSplit = splitStepMm > 0 && depthMm;
+
+    forEachActive([&](int x, int y) {
+        int idx = y * width + x;
+        int lbl = labels[idx];
+        if (lbl == 0) return;
+
+        int root = uf.find(lbl);
+        if (sawWeak) {
+            uint8_t* px = bgr + idx * 3;
+            if (!rootStrong[root]) {
+                // Weak-only component: not grown from any seed -> background
+                px[0] = px[1] = px[2] = 255;
+                labels[idx] = 0;
+                return;
+            }
+            px[0] = px[1] = px[2] = 0;
+        }
+        labels[idx] = root;
+
+        int blobIdx = rootToBlob[root];
+        if (blobIdx == -1) {
+            int n = labelCount[root];
+            bool oversized = n > maxBlobPixels;
+            if (n < minBlobPixels || (oversized && !canSplit)) {
+                rootToBlob[root] = -2;
+                return;
+            }
+            blobIdx = static_cast<int>(blobs.size());
+            rootToBlob[root] = blobIdx;
+            blobs.push_back(startBlob(x, y, root, zoneMap ? zoneMap[idx] : 0,
+                                      bandMap ? bandMap[idx] : 0));
+            if (oversized) blobs.back().pixelCount = n;
+        }
+        if (blobIdx < 0) return;
+
+        BlobInfo& b = blobs[blobIdx];
+        if (b.pixelCount > maxBlobPixels) {
+            // Too large to be kept, only the bbox for splitBlobByDepth
+            if (x < b.minX) b.minX = x;
+            if (x > b.maxX) b.maxX = x;
+            if (y > b.maxY) b.maxY = y;
+            return;
+        }
+        accumulateBlobPixel(b, x, y, idx, depthMm);
+    });
+
+    // ---- Filter, compute averages, draw rectangles ----
+    return selectAndDrawBlobs(bgr, width, height, blobs, labels, nextLabel, maxBlobPixels,
+                              depthMm, minBlobPixels, splitStepMm, maxBlobs, nearestFirst);
+}
@@ -0,0 +1,401 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "blobtracker.hpp"
+#include "zones.hpp"
+
+// Blob wire formats pushed to WebServer::updateBlobs. Shared by both platforms
+// so the JSON (served on /blobs and /events) and the binary stream
+// (/blobs.bin) stay identical.
+
+// One tracked layer per depth band (see bands.hpp). Each layer has its own
+// tracker, so blob ids are only unique within a layer.
+struct BlobLayer {
+    int band;
+    uint16_t nearMm, farMm;
+    const std::vector<TrackedBlob>* blobs;
+};
+
+inline void appendBlobJson(std::string& json, const TrackedBlob& t, bool withZone) {
+    char shape[384];
+    const BlobKalman& k = t.motion;
+    std::snprintf(shape, sizeof(shape),
+                  ",\"cx\":%.1f,\"cy\":%.1f,\"dcx\":%.1f,\"dcy\":%.1f,\"angle\":%.1f,\"ecc\":%.3f"
+                  ",\"xyz\":[%.0f,%.0f,%.0f],\"pos\":[%.1f,%.1f],\"vel\":[%.0f,%.0f],\"acc\":[%.0f,%.0f]",
+                  t.centroidX, t.centroidY, t.depthCx, t.depthCy, t.angleDeg, t.eccentricity,
+                  t.xMm, t.yMm, t.zMm, k.pos[0], k.pos[1], k.vel[0], k.vel[1], k.acc[0], k.acc[1]);
+    json += "{\"id\":" + std::to_string(t.serial) + shape +
+            ",\"avg\":" + std::to_string(static_cast<int>(t.avgDepthMm + 0.5f)) +
+            ",\"max\":" + std::to_string(static_cast<int>(t.maxDepthMm)) +
+            ",\"min\":" + std::to_string(static_cast<int>(t.minDepthMm)) +
+            ",\"minx\":" + std::to_string(t.minDepthX) +
+            ",\"miny\":" + std::to_string(t.minDepthY) +
+            ",\"p10\":" + std::to_string(static_cast<int>(t.p10Mm + 0.5f)) +
+            ",\"med\":" + std::to_string(static_cast<int>(t.medianMm + 0.5f)) +
+            ",\"p90\":" + std::to_string(static_cast<int>(t.p90Mm + 0.5f)) +
+            ",\"px\":" + std::to_string(t.pixelCount) +
+            ",\"miss\":" + std::to_string(t.misses);
+    if (withZone) json += ",\"zone\":" + std::to_string(t.zone);
+    if (t.hasColor)
+        json += ",\"rgb\":[" + std::to_string(t.colorR) + "," + std::to_string(t.colorG) + "," +
+                std::to_string(t.colorB) + "]";
+    if (!t.contour.empty()) {
+        json += ",\"contour\":[";
+        for (size_t i = 0; i < t.contour.size(); i++) {
+            if (i > 0) json += ",";
+            json += std::to_string(t.contour[i].x) + "," + std::to_string(t.contour[i].y);
+        }
+        json += "]";
+    }
+    if (!t.tips.empty() || t.defects > 0) {
+        json += ",\"defects\":" + std::to_string(t.defects) + ",\"tips\":[";
+        for (size_t i = 0; i < t.tips.size(); i++) {
+            const BlobTip& p = t.tips[i];
+            if (i > 0) json += ",";
+            json += "{\"id\":" + std::to_string(p.id) +
+                    ",\"x\":" + std::to_string(p.x) +
+                    ",\"y\":" + std::to_string(p.y) +
+                    ",\"d\":" + std::to_string(p.depthMm) +
+                    ",\"xyz\":[" + std::to_string(static_cast<int>(std::lround(p.xMm))) +
+                    "," + std::to_string(static_cast<int>(std::lround(p.yMm))) +
+                    "," + std::to_string(static_cast<int>(std::lround(p.zMm))) + "]}";
+        }
+        json += "]";
+    }
+    json += "}";
+}
+
+inline void appendBlobArrayJson(std::string& json, const std::vector<TrackedBlob>& tracked,
+                                bool withZone) {
+    json += "[";
+    bool first = true;
+    for (const auto& t : tracked) {
+        if (!t.confirmed) continue;
+        if (!first) json += ",";
+        first = false;
+        appendBlobJson(json, t, withZone);
+    }
+    json += "]";
+}
+
+//   {"w":640,"h":400,"blobs":[{"id":3,"cx":..,"cy":..,"dcx":..,"dcy":..,"angle":..,
+//                               "ecc":..,"xyz":[x,y,z],"pos":[x,y],"vel":[vx,vy],
+//                               "acc":[ax,ay],"avg":..,"max":..,"min":..,"minx":..,
+//                               "miny":..,"p10":..,"med":..,"p90":..,"px":..,"miss":..}]}
+// cx/cy are the sub-pixel centroid, dcx/dcy the depth-weighted one, angle the
+// principal axis in degrees (image coordinates) and ecc the eccentricity.
+// xyz is the camera-space position in mm (x right, y down, z forward; the mean
+// of the blob's 3D points, see deproject.hpp), all 0 without intrinsics.
+// pos / vel / acc come from the track's Kalman filter (kalman.hpp): filtered
+// centroid (px), velocity (px/s) and acceleration (px/s^2), image coordinates.
+// min is the nearest valid depth (at minx, miny); p10 / med / p90 are depth
+// percentiles from the blob's histogram, all in mm (0 = no valid depth).
+// Only confirmed tracks are listed; miss > 0 means the blob was not seen for
+// that many frames and its position is the tracker's prediction (coasting).
+// When zones are active each blob carries its "zone" id and a top-level
+// "zones" array reports per-zone occupancy (see zoneOccupancyJson).
+// With depth bands, "layers" holds one entry per band and "blobs" mirrors the
+// first layer for clients that don't know about layers.
+// With contours on, each blob has "contour":[x0,y0,x1,y1,...] (closed, clockwise).
+// With tips on, "defects" counts convexity defects and "tips" lists extremities
+// as {"id","x","y","d","xyz"} (d = depth mm); tip ids are stable within a blob.
+// In color mode "rgb" is the blob's mean color as seen by the color camera
+// (registration.hpp); it is left out when none of its pixels is visible there.
+inline std::string blobsJson(int width, int height, const std::vector<TrackedBlob>& tracked,
+                             const ZoneMap* zones = nullptr,
+                             const ZoneOccupancy* occupancy = nullptr,
+                             const std::vector<BlobLayer>* layers = nullptr) {
+    bool withZones = zones && occupancy && zones->count > 0;
+    std::string json = "{\"w\":" + std::to_string(width) +
+                       ",\"h\":" + std::to_string(height) +
+                       ",\"blobs\":";
+    appendBlobArrayJson(json, tracked, withZones);
+    if (layers) {
+        json += ",\"layers\":[";
+        for (size_t l = 0; l < layers->size(); l++) {
+            const auto& layer = (*layers)[l];
+            if (l > 0) json += ",";
+            json += "{\"band\":" + std::to_string(layer.band) +
+                    ",\"near\":" + std::to_string(layer.nearMm) +
+                    ",\"far\":" + std::to_string(layer.farMm) +
+                    ",\"blobs\":";
+            appendBlobArrayJson(json, *layer.blobs, withZones);
+            json += "}";
+        }
+        json += "]";
+    }
+    if (withZones) json += ",\"zones\":" + zoneOccupancyJson(*zones, *occupancy);
+    json += "}";
+    return json;
+}
+
+// Binary blob frame (little-endian), served on /blobs.bin:
+//   header  16 bytes: "DPB1", u32 seq (filled in by the server), u16 width,
+//                     u16 height, u16 layer count, u16 blob record size
+//                     (bytes before the vertices, kBlobBinBlobSize)
+//   layer    4 bytes: u8 band, u8 reserved, u16 blob count, then per blob
+//   blob    60 bytes: u32 id, u16 cx, u16 cy, u16 avg mm, u16 max mm,
+//                     u32 pixel count, u8 zone, u8 band, u16 vertex count,
+//                     u8 tip count, u8 defect count, u8 miss count, u8 reserved,
+//                     u16 min mm, u16 min x, u16 min y,
+//                     u16 p10 mm, u16 median mm, u16 p90 mm,
+//                     i16 x mm, i16 y mm, u16 z mm, u16 reserved,
+//                     u16 filtered x, u16 filtered y (1/8 px),
+//                     i16 vx, i16 vy (px/s), i16 ax, i16 ay (px/s^2),
+//                     u8 r, u8 g, u8 b (mean registered color), u8 color flags
+//                     (bit 0: has color),
+//                     then 4 bytes per contour vertex: i16 x, i16 y,
+//                     then 12 bytes per tip: u16 id, u16 x, u16 y, u16 depth mm,
+//                     i16 x mm, i16 y mm
+// Without bands there is a single layer with band 0. Fields are only ever
+// appended to the fixed blob record: readers take the record size from the
+// header and skip trailing bytes they don't know, so older readers keep working.
+constexpr size_t kBlobBinHeaderSize = 16;
+constexpr size_t kBlobBinLayerSize = 4;
+constexpr size_t kBlobBinBlobSize = 60;
+constexpr size_t kBlobBinVertexSize = 4;
+constexpr size_t kBlobBinTipSize = 12;
+
+inline void putU16(std::string& out, size_t pos, uint32_t v) {
+    out[pos] = static_cast<char>(v & 0xFF);
+    out[pos + 1] = static_cast<char>((v >> 8) & 0xFF);
+}
+
+inline void putU32(std::string& out, size_t pos, uint32_t v) {
+    putU16(out, pos, v & 0xFFFF);
+    putU16(out, pos + 2, v >> 16);
+}
+
+// Signed value (camera-space mm, velocity, acceleration) as a saturated i16 field.
+inline uint32_t toI16(float v) {
+    long r = std::lround(v);
+    if (r < -32768) r = -32768;
+    if (r > 32767) r = 32767;
+    return static_cast<uint16_t>(static_cast<int16_t>(r));
+}
+
+// Image position in 1/8 px as a u16 field (clamped to the frame's positive range).
+inline uint32_t subPixel(float v) {
+    long r = std::lround(v * 8.0f);
+    if (r < 0) r = 0;
+    if (r > 65535) r = 65535;
+    return static_cast<uint32_t>(r);
+}
+
+inline std::string blobsBinary(int width, int height, const std::vector<TrackedBlob>& tracked,
+                               const std::vector<BlobLayer>* layers = nullptr) {
+    std::vector<BlobLayer> single;
+    if (!layers) {
+        single.push_back({0, 0, 0, &tracked});
+        layers = &single;
+    }
+    // Tentative tracks are not published
+    size_t size = kBlobBinHeaderSize;
+    for (const auto& layer : *layers) {
+        size += kBlobBinLayerSize;
+        for (const auto& t : *layer.blobs) {
+            if (!t.confirmed) continue;
+            size += kBlobBinBlobSize + t.contour.size() * kBlobBinVertexSize +
+                    t.tips.size() * kBlobBinTipSize;
+        }
+    }
+
+    std::string out(size, '\0');
+    out[0] = 'D'; out[1] = 'P'; out[2] = 'B'; out[3] = '1';
+    putU16(out, 8, static_cast<uint32_t>(width));
+    putU16(out, 10, static_cast<uint32_t>(height));
+    putU16(out, 12, static_cast<uint32_t>(layers->size()));
+    putU16(out, 14, static_cast<uint32_t>(kBlobBinBlobSize));
+
+    size_t pos = kBlobBinHeaderSize;
+    for (const auto& layer : *layers) {
+        size_t count = 0;
+        for (const auto& t : *layer.blobs) count += t.confirmed ? 1 : 0;
+        out[pos] = static_cast<char>(layer.band);
+        putU16(out, pos + 2, static_cast<uint32_t>(count));
+        pos += kBlobBinLayerSize;
+        for (const auto& t : *layer.blobs) {
+            if (!t.confirmed) continue;
+            putU32(out, pos, static_cast<uint32_t>(t.serial));
+            putU16(out, pos + 4, static_cast<uint32_t>(t.cx));
+            putU16(out, pos + 6, static_cast<uint32_t>(t.cy));
+            putU16(out, pos + 8, static_cast<uint32_t>(t.avgDepthMm + 0.5f));
+            putU16(out, pos + 10, t.maxDepthMm);
+            putU32(out, pos + 12, static_cast<uint32_t>(t.pixelCount));
+            out[pos + 16] = static_cast<char>(t.zone);
+            out[pos + 17] = static_cast<char>(t.band);
+            putU16(out, pos + 18, static_cast<uint32_t>(t.contour.size()));
+            out[pos + 20] = static_cast<char>(t.tips.size());
+            out[pos + 21] = static_cast<char>(t.defects > 255 ? 255 : t.defects);
+            out[pos + 22] = static_cast<char>(t.misses);
+            putU16(out, pos + 24, t.minDepthMm);
+            putU16(out, pos + 26, static_cast<uint32_t>(t.minDepthX));
+            putU16(out, pos + 28, static_cast<uint32_t>(t.minDepthY));
+            putU16(out, pos + 30, static_cast<uint32_t>(t.p10Mm + 0.5f));
+            putU16(out, pos + 32, static_cast<uint32_t>(t.medianMm + 0.5f));
+            putU16(out, pos + 34, static_cast<uint32_t>(t.p90Mm + 0.5f));
+            putU16(out, pos + 36, toI16(t.xMm));
+            putU16(out, pos + 38, toI16(t.yMm));
+            putU16(out, pos + 40, static_cast<uint32_t>(t.zMm + 0.5f));
+            putU16(out, pos + 44, subPixel(t.motion.pos[0]));
+            putU16(out, pos + 46, subPixel(t.motion.pos[1]));
+            putU16(out, pos + 48, toI16(t.motion.vel[0]));
+            putU16(out, pos + 50, toI16(t.motion.vel[1]));
+            putU16(out, pos + 52, toI16(t.motion.acc[0]));
+            putU16(out, pos + 54, toI16(t.motion.acc[1]));
+            if (t.hasColor) {
+                out[pos + 56] = static_cast<char>(t.colorR);
+                out[pos + 57] = static_cast<char>(t.colorG);
+                out[pos + 58] = static_cast<char>(t.colorB);
+                out[pos + 59] = 1;
+            }
+            pos += kBlobBinBlobSize;
+            for (const auto& p : t.contour) {
+                putU16(out, pos, static_cast<uint16_t>(p.x));
+                putU16(out, pos + 2, static_cast<uint16_t>(p.y));
+                pos += kBlobBinVertexSize;
+            }
+            for (const auto& p : t.tips) {
+                putU16(out, pos, static_cast<uint32_t>(p.id));
+                putU16(out, pos + 2, static_cast<uint16_t>(p.x));
+                putU16(out, pos + 4, static_cast<uint16_t>(p.y));
+                putU16(out, pos + 6, p.depthMm);
+                putU16(out, pos + 8, toI16(p.xMm));
+                putU16(out, pos + 10, toI16(p.yMm));
+                pos += kBlobBinTipSize;
+            }
+        }
+    }
+    return out;
+}
+
+// Track histories for /tracks:
+//   {"ms":..,"tracks":[{"band":0,"id":3,"s":[age,x,y,d, age,x,y,d, ...]}]}
+// Samples are oldest first, flattened four numbers each: age in ms before
+// "ms" (the latest frame), the centroid x, y (px) and the average depth (mm).
+// id / band >= 0 select one track / one layer; maxSamples > 0 keeps only the
+// newest samples of each track.
+inline std::string tracksJson(const TrackHistorySnapshot& snap, int id = -1, int band = -1,
+                              int maxSamples = 0) {
+    std::string json = "{\"ms\":" + std::to_string(snap.ms) + ",\"tracks\":[";
+    bool first = true;
+    char buf[64];
+    for (const auto& t : snap.tracks) {
+        if ((id >= 0 && t.id != id) || (band >= 0 && t.band != band)) continue;
+        if (!first) json += ",";
+        first = false;
+        json += "{\"band\":" + std::to_string(t.band) + ",\"id\":" + std::to_string(t.id) + ",\"s\":[";
+        size_t begin = t.begin;
+        if (maxSamples > 0 && t.count > static_cast<size_t>(maxSamples))
+            begin += t.count - maxSamples;
+        for (size_t i = begin; i < t.begin + t.count; i++) {
+            const auto& s = snap.samples[i];
+            std::snprintf(buf, sizeof(buf), "%s%lld,%.1f,%.1f,%d", i > begin ? "," : "",
+                          snap.ms - s.ms, s.x, s.y, static_cast<int>(s.depthMm));
+            json += buf;
+        }
+        json += "]}";
+    }
+    json += "]}";
+    return json;
+}
+
+// Tracker checkpoint for /checkpoint (see TrackerCheckpoint):
+//   {"ms":..,"width":..,"height":..,"layers":[{"band":0,"nextSerial":..,
+//    "tracks":[{"id":3,"x":..,"y":..,"vx":..,"vy":..,"d":..,"px":..,"zone":..}]}]}
+// Layer band 0 is the single tracker, bands 1.. the depth band trackers.
+inline void appendTrackerStateJson(std::string& json, int band, const TrackerState& state) {
+    json += "{\"band\":" + std::to_string(band) + ",\"nextSerial\":" +
+            std::to_string(state.nextSerial) + ",\"tracks\":[";
+    char buf[192];
+    for (size_t i = 0; i < state.tracks.size(); i++) {
+        const auto& t = state.tracks[i];
+        std::snprintf(buf, sizeof(buf),
+                      "%s{\"id\":%d,\"x\":%.1f,\"y\":%.1f,\"vx\":%.1f,\"vy\":%.1f,\"d\":%d,"
+                      "\"px\":%d,\"zone\":%d}",
+                      i > 0 ? "," : "", t.serial, t.x, t.y, t.vx, t.vy,
+                      static_cast<int>(t.depthMm + 0.5f), t.pixelCount, t.zone);
+        json += buf;
+    }
+    json += "]}";
+}
+
+inline std::string checkpointJson(const TrackerCheckpoint& cp) {
+    std::string json = "{\"ms\":" + std::to_string(cp.ms) + ",\"width\":" + std::to_string(cp.width) +
+                       ",\"height\":" + std::to_string(cp.height) + ",\"layers\":[";
+    appendTrackerStateJson(json, 0, cp.single);
+    for (size_t i = 0; i < cp.bandStates.size(); i++) {
+        json += ",";
+        appendTrackerStateJson(json, static_cast<int>(i) + 1, cp.bandStates[i]);
+    }
+    json += "]}";
+    return json;
+}
+
+// One recognized gesture (gestures.hpp), sent as an "event: gesture" message on /events:
+//   {"seq":..,"type":"swipe","dir":"right","band":0,"id":3,"id2":0,"x":..,"y":..,
+//    "value":..,"ms":..}
+// dir is left/right/up/down for swipes, cw/ccw for circles, in/out for pinches
+// and empty otherwise; value is the duration (ms) of a tap or hold, the speed
+// (px/s) of a swipe and the distance ratio of a pinch. seq numbers the events.
+inline const char* gestureDirName(const GestureEvent& e) {
+    switch (e.type) {
+    case GestureType::Swipe:
+        return e.dir == kSwipeLeft ? "left" : e.dir == kSwipeRight ? "right" : e.dir == kSwipeUp ? "up" : "down";
+    case GestureType::Circle: return e.dir == kClockwise ? "cw" : "ccw";
+    case GestureType::Pinch: return e.dir == kPinchOut ? "out" : "in";
+    default: return "";
+    }
+}
+
+inline std::string gestureJson(const GestureEvent& e, int seq) {
+    char buf[256];
+    std::snprintf(buf, sizeof(buf),
+                  "{\"seq\":%d,\"type\":\"%s\",\"dir\":\"%s\",\"band\":%d,\"id\":%d,\"id2\":%d,"
+                  "\"x\":%.1f,\"y\":%.1f,\"value\":%.2f,\"ms\":%lld}",
+                  seq, gestureName(e.type), gestureDirName(e), e.band, e.id, e.id2, e.x, e.y, e.value, e.ms);
+    return buf;
+}
+
+// Binary gesture batch (little-endian), served on /gestures.bin:
+//   header  16 bytes: "DPG1", u32 seq of the last event, u16 event count,
+//                     u16 reserved, u32 reserved
+//   event   28 bytes: u32 seq, u8 type (1 tap, 2 hold, 3 swipe, 4 circle,
+//                     5 pinch), i8 dir (swipe 1 left, 2 right, 3 up, 4 down;
+//                     circle / pinch +1 cw / out, -1 ccw / in), u8 band,
+//                     u8 reserved, u32 id, u32 id2, u16 x, u16 y (1/8 px),
+//                     f32 value, u32 ms (low 32 bits)
+constexpr size_t kGestureBinHeaderSize = 16;
+constexpr size_t kGestureBinEventSize = 28;
+
+// events[i] has sequence number firstSeq + i.
+inline std::string gesturesBinary(const std::vector<GestureEvent>& events, int firstSeq) {
+    std::string out(kGestureBinHeaderSize + events.size() * kGestureBinEventSize, '\0');
+    out[0] = 'D'; out[1] = 'P'; out[2] = 'G'; out[3] = '1';
+    putU32(out, 4, static_cast<uint32_t>(firstSeq + static_cast<int>(events.size()) - 1));
+    putU16(out, 8, static_cast<uint32_t>(events.size()));
+    size_t pos = kGestureBinHeaderSize;
+    for (size_t i = 0; i < events.size(); i++) {
+        const auto& e = events[i];
+        putU32(out, pos, static_cast<uint32_t>(firstSeq + static_cast<int>(i)));
+        out[pos + 4] = static_cast<char>(e.type);
+        out[pos + 5] = static_cast<char>(e.dir);
+        out[pos + 6] = static_cast<char>(e.band);
+        putU32(out, pos + 8, static_cast<uint32_t>(e.id));
+        putU32(out, pos + 12, static_cast<uint32_t>(e.id2));
+        putU16(out, pos + 16, subPixel(e.x));
+        putU16(out, pos + 18, subPixel(e.y));
+        uint32_t bits;
+        std::memcpy(&bits, &e.value, 4);
+        putU32(out, pos + 20, bits);
+        putU32(out, pos + 24, static_cast<uint32_t>(e.ms));
+        pos += kGestureBinEventSize;
+    }
+    return out;
+}
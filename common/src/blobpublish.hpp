@@ -0,0 +1,136 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+#include "blobjson.hpp"
+
+// Decides per frame whether the tracked blobs are worth publishing: the
+// published (confirmed) tracks are diffed against what was last sent, and a
+// frame only goes out when a track started or ended, one moved more than
+// epsPx pixels or epsMm in depth since it was last sent, a fingertip appeared,
+// vanished or moved more than epsPx, a track's miss count changed, or a zone's
+// blob count or nearest depth (beyond epsMm) changed. Outlines are not
+// compared (they flicker by a pixel every frame) and refresh with the next
+// frame that goes out. Every keyframeMs a frame goes out regardless, so
+// clients that missed one resync. This is not an event stream: a frame that
+// goes out is still a full snapshot of every blob (every message stands on
+// its own), the saving is in the frames that are skipped: no serialization,
+// no client wakeups and no traffic while the scene is still. Disabled, every
+// frame is published.
+class BlobPublishFilter {
+public:
+    void configure(bool enabled, int epsPx, int epsMm, int keyframeMs) {
+        enabled_ = enabled;
+        epsPx_ = static_cast<float>(epsPx);
+        epsMm_ = static_cast<float>(epsMm);
+        keyframeMs_ = keyframeMs;
+        lastSentMs_ = -1;   // publish the next frame
+    }
+
+    // Call once per frame with what blobsJson / blobsBinary would be given.
+    bool due(long long ms, const std::vector<TrackedBlob>& tracked,
+             const std::vector<BlobLayer>* layers = nullptr,
+             const ZoneMap* zones = nullptr, const ZoneOccupancy* occupancy = nullptr) {
+        if (!enabled_) return true;
+        cur_.clear();
+        curTips_.clear();
+        if (layers) {
+            for (const auto& l : *layers) collect(l.band, *l.blobs);
+        } else {
+            collect(0, tracked);
+        }
+        std::sort(cur_.begin(), cur_.end(), [](const Sent& a, const Sent& b) {
+            return a.band != b.band ? a.band < b.band : a.serial < b.serial;
+        });
+        curZones_.clear();
+        if (zones && occupancy) {
+            for (int z = 1; z <= zones->count; z++)
+                curZones_.push_back({occupancy->blobCount[z], occupancy->nearestMm[z]});
+        }
+
+        bool send = lastSentMs_ < 0 || ms - lastSentMs_ >= keyframeMs_ || moved() || zonesChanged();
+        if (!send) return false;
+        sent_.swap(cur_);
+        sentTips_.swap(curTips_);
+        sentZones_.swap(curZones_);
+        lastSentMs_ = ms;
+        return true;
+    }
+
+private:
+    struct Sent {
+        int band;
+        int serial;
+        float x, y;
+        float depthMm;
+        int misses;
+        size_t tipBegin, tipCount;   // range in the frame's tip list
+    };
+
+    struct SentTip {
+        int id;
+        int x, y;
+    };
+
+    struct SentZone {
+        int blobs;
+        int nearestMm;
+    };
+
+    void collect(int band, const std::vector<TrackedBlob>& tracked) {
+        for (const auto& t : tracked) {
+            if (!t.confirmed) continue;
+            cur_.push_back({band, t.serial, t.centroidX, t.centroidY, t.avgDepthMm, t.misses,
+                            curTips_.size(), t.tips.size()});
+            for (const auto& tip : t.tips) curTips_.push_back({tip.id, tip.x, tip.y});
+        }
+    }
+
+    // Same tracks as last sent, each within the epsilons of where it was sent,
+    // with the same fingertips, each within epsPx of where it was sent
+    bool moved() const {
+        if (cur_.size() != sent_.size()) return true;
+        for (size_t i = 0; i < cur_.size(); i++) {
+            const Sent& c = cur_[i];
+            const Sent& s = sent_[i];
+            if (c.band != s.band || c.serial != s.serial || c.misses != s.misses) return true;
+            if (c.x - s.x > epsPx_ || s.x - c.x > epsPx_) return true;
+            if (c.y - s.y > epsPx_ || s.y - c.y > epsPx_) return true;
+            if (c.depthMm - s.depthMm > epsMm_ || s.depthMm - c.depthMm > epsMm_) return true;
+            if (c.tipCount != s.tipCount) return true;
+            for (size_t k = 0; k < c.tipCount; k++) {
+                const SentTip& ct = curTips_[c.tipBegin + k];
+                const SentTip& st = sentTips_[s.tipBegin + k];
+                if (ct.id != st.id) return true;
+                if (std::abs(ct.x - st.x) > epsPx_ || std::abs(ct.y - st.y) > epsPx_) return true;
+            }
+        }
+        return false;
+    }
+
+    bool zonesChanged() const {
+        if (curZones_.size() != sentZones_.size()) return true;
+        for (size_t z = 0; z < curZones_.size(); z++) {
+            const SentZone& c = curZones_[z];
+            const SentZone& s = sentZones_[z];
+            if (c.blobs != s.blobs) return true;
+            if ((c.nearestMm == 0) != (s.nearestMm == 0)) return true;
+            if (std::abs(c.nearestMm - s.nearestMm) > epsMm_) return true;
+        }
+        return false;
+    }
+
+    bool enabled_ = false;
+    float epsPx_ = 0.0f;
+    float epsMm_ = 0.0f;
+    int keyframeMs_ = 1000;
+    long long lastSentMs_ = -1;
+    std::vector<Sent> cur_;
+    std::vector<Sent> sent_;
+    std::vector<SentTip> curTips_;
+    std::vector<SentTip> sentTips_;
+    std::vector<SentZone> curZones_;
+    std::vector<SentZone> sentZones_;
+};
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "blobdetect.hpp"
+#include "contour.hpp"
+#include "hull.hpp"
+
+// Per-blob geometry stage, run on the label image left by detectAndDrawBlobs
+// (labelBuffer). For every kept blob the border is traced once; from it come
+// the simplified outline, the convex hull with its convexity defects and the
+// extremity points (fingertips). Only border pixels are visited, and the
+// scratch buffers live in the analyzer, so steady-state frames don't allocate
+// beyond the per-blob result vectors.
+class BlobShapeAnalyzer {
+public:
+    // epsilon > 0: store the Douglas-Peucker outline (px tolerance) in BlobInfo::contour,
+    // with at most maxVertices vertices (0 = no limit).
+    // maxTips > 0: find up to that many extremities per blob.
+    void configure(float epsilon, int maxVertices, int maxTips) {
+        epsilon_ = epsilon;
+        maxVertices_ = maxVertices;
+        maxTips_ = maxTips;
+    }
+
+    bool enabled() const { return epsilon_ > 0.0f || maxTips_ > 0; }
+
+    void analyze(std::vector<BlobInfo>& blobs, const std::vector<int>& labels,
+                 int width, int height, const uint16_t* depthMm) {
+        if (!enabled()) return;
+        for (auto& b : blobs) {
+            traceContour(labels.data(), width, height, b.label, b.startX, b.startY, border_);
+
+            b.tips.clear();
+            b.defects = 0;
+            if (maxTips_ > 0) findTips(b, width, height, depthMm);
+
+            if (epsilon_ > 0.0f) {
+                b.contour = border_;
+                simplifyContour(b.contour, epsilon_, keep_, splits_, maxVertices_);
+            } else {
+                b.contour.clear();
+            }
+        }
+    }
+
+private:
+    void findTips(BlobInfo& b, int width, int height, const uint16_t* depthMm) {
+        convexHull(border_, hull_, order_);
+
+        // Scale the thresholds with the blob: r is the radius of a disc of equal area
+        float r = std::sqrt(b.pixelCount / 3.14159265f);
+        convexityDefects(border_, hull_, 0.3f * r, defects_);
+        b.defects = static_cast<int>(defects_.size());
+
+        int k = static_cast<int>(border_.size()) / 40;
+        if (k < 4) k = 4;
+        findExtremities(border_, hull_, b.cx, b.cy, r, k, kMaxTipAngleDeg,
+                        0.5f * r, maxTips_, tipIdx_, candidates_);
+
+        for (int i : tipIdx_) {
+            const ContourPoint& p = border_[i];
+            b.tips.push_back({p.x, p.y, tipDepth(p.x, p.y, width, height, depthMm), 0});
+        }
+    }
+
+    // Depth at the tip, or the nearest valid depth among its 8 neighbors
+    // (border pixels often sit on invalid stereo / ToF edges).
+    static uint16_t tipDepth(int x, int y, int width, int height, const uint16_t* depthMm) {
+        if (!depthMm) return 0;
+        uint16_t d = depthMm[y * width + x];
+        if (d) return d;
+        for (int dy = -1; dy <= 1; dy++) {
+            for (int dx = -1; dx <= 1; dx++) {
+                int nx = x + dx, ny = y + dy;
+                if (nx < 0 || ny < 0 || nx >= width || ny >= height) continue;
+                uint16_t v = depthMm[ny * width + nx];
+                if (v && (!d || v < d)) d = v;
+            }
+        }
+        return d;
+    }
+
+    static constexpr float kMaxTipAngleDeg = 60.0f;
+
+    float epsilon_ = 0.0f;
+    int maxVertices_ = 0;
+    int maxTips_ = 0;
+
+    std::vector<ContourPoint> border_;
+    std::vector<uint8_t> keep_;
+    std::vector<ContourSplit> splits_;
+    std::vector<int> hull_;
+    std::vector<int> order_;
+    std::vector<ConvexityDefect> defects_;
+    std::vector<int> tipIdx_;
+    std::vector<std::pair<float, int>> candidates_;
+};
@@ -1,121 +1,566 @@
 #pragma once
 
-#include <algorithm>
 #include <cmath>
-#include <cstdio>
 #include <cstdint>
+#include <utility>
 #include <vector>
 
+#include "assignment.hpp"
 #include "blobdetect.hpp"
+#include "eventlog.hpp"
+#include "gestures.hpp"
+#include "kalman.hpp"
+#include "trackerstate.hpp"
+#include "trajectory.hpp"
 
 struct TrackedBlob {
-    int serial;
-    int cx, cy;          // centroid position
+    int serial;          // 0 while tentative, assigned on confirmation
+    int cx, cy;          // centroid position (rounded)
+    float centroidX, centroidY;   // sub-pixel centroid from image moments
+    float depthCx, depthCy;       // depth-weighted centroid
+    float angleDeg;               // principal axis orientation
+    float eccentricity;           // 0 = round, towards 1 = elongated
     int pixelCount;
     float avgDepthMm;
     uint16_t maxDepthMm;
+    uint16_t minDepthMm;          // nearest valid depth, at (minDepthX, minDepthY)
+    int minDepthX, minDepthY;
+    float p10Mm, medianMm, p90Mm; // depth percentiles (robust to flying pixels)
+    float xMm, yMm, zMm;          // camera-space position (0 without intrinsics)
+    int zone;            // zone id of the latest matched blob (0 = no zone)
+    int band;            // depth band id (0 = single-threshold mode)
+    std::vector<ContourPoint> contour;  // simplified outline (empty when contours are off)
+    std::vector<BlobTip> tips;          // extremities with ids stable within this track
+    int defects;
+    uint8_t colorB, colorG, colorR;   // mean registered color (hasColor false: none)
+    bool hasColor;
+    int nextTipId;
+    BlobKalman motion;   // filtered position (px), velocity (px/s), acceleration (px/s^2)
+    bool confirmed;      // matched for the confirmation frames; only confirmed tracks are published
+    int hits;            // frames matched since birth
+    int misses;          // consecutive unmatched frames (coasting on the prediction while > 0)
+    int historySlot;     // trajectory ring in the tracker's TrajectoryPool
+    int grace;           // extra frames it may coast (restored, not yet re-associated)
+    GestureTrack gesture;
 };
 
 class BlobTracker {
 public:
     // Update tracking with the latest detected blobs.
-    // Prints Cursor start/moved/end messages to stdout.
-    void update(const std::vector<BlobInfo>& blobs, int frameCount, long long ms) {
-        // Compute centroids for incoming blobs
-        struct Incoming {
-            int cx, cy;
-            int idx;  // index into blobs vector
-        };
-        std::vector<Incoming> incoming;
-        incoming.reserve(blobs.size());
-        for (size_t i = 0; i < blobs.size(); i++) {
-            int cx = (blobs[i].minX + blobs[i].maxX) / 2;
-            int cy = (blobs[i].minY + blobs[i].maxY) / 2;
-            incoming.push_back({cx, cy, static_cast<int>(i)});
-        }
+    // Logs Cursor start (info), moved (debug) and end (info) events for
+    // confirmed tracks to the asynchronous eventLog(). The contours are moved
+    // out of blobs into the tracks, so no outline is copied per frame.
+    void update(std::vector<BlobInfo>&& blobs, int frameCount, long long ms) {
+        events_.clear();
 
-        // Build candidate match pairs (active × incoming) within kMatchRadius
-        struct MatchPair {
-            int activeIdx;
-            int incomingIdx;
-            int distSq;
-        };
-        std::vector<MatchPair> candidates;
-        for (size_t a = 0; a < active_.size(); a++) {
-            for (size_t n = 0; n < incoming.size(); n++) {
-                int dx = active_[a].cx - incoming[n].cx;
-                int dy = active_[a].cy - incoming[n].cy;
-                int dsq = dx * dx + dy * dy;
-                if (dsq <= kMatchRadiusSq) {
-                    candidates.push_back({static_cast<int>(a), static_cast<int>(n), dsq});
-                }
-            }
+        // Incoming centroids (from image moments, stable when the bbox changes shape)
+        incoming_.clear();
+        for (size_t i = 0; i < blobs.size(); i++) {
+            int cx = static_cast<int>(blobs[i].cx + 0.5f);
+            int cy = static_cast<int>(blobs[i].cy + 0.5f);
+            incoming_.push_back({cx, cy, static_cast<int>(i)});
         }
 
-        // Greedy match: sort by distance, assign closest first
-        std::sort(candidates.begin(), candidates.end(),
-                  [](const MatchPair& a, const MatchPair& b) { return a.distSq < b.distSq; });
+        // Predict every track to this frame, then gate the incoming blobs
+        // against the predictions: candidate pairs, closest first
+        float dt = frameDt(ms);
+        predictTracks(dt);
+        buildCandidates();
 
-        std::vector<bool> activeMatched(active_.size(), false);
-        std::vector<bool> incomingMatched(incoming.size(), false);
-
-        for (const auto& m : candidates) {
-            if (activeMatched[m.activeIdx] || incomingMatched[m.incomingIdx]) continue;
-            activeMatched[m.activeIdx] = true;
-            incomingMatched[m.incomingIdx] = true;
+        activeMatched_.assign(active_.size(), 0);
+        incomingMatched_.assign(incoming_.size(), 0);
+        matches_.clear();
+        if (optimal_) assignOptimal();
+        else assignGreedy();
 
+        for (const auto& m : matches_) {
             // Update tracked blob position
-            const auto& inc = incoming[m.incomingIdx];
-            const auto& b = blobs[inc.idx];
+            const auto& inc = incoming_[m.incomingIdx];
+            auto& b = blobs[inc.idx];
             auto& t = active_[m.activeIdx];
             t.cx = inc.cx;
             t.cy = inc.cy;
-            t.pixelCount = b.pixelCount;
-            t.avgDepthMm = b.avgDepthMm;
-            t.maxDepthMm = b.maxDepthMm;
+            assignMeasurement(t, b);
+            matchTips(t, b.tips);
+            t.motion.correct(b.cx, b.cy, dt);
+            t.hits++;
+            t.misses = 0;
+            t.grace = 0;
+            record(t, ms);
 
-            std::printf("[%6d %7lldms] Cursor moved #%d to (%d, %d) %dmm\n",
-                        frameCount, ms, t.serial, t.cx, t.cy,
-                        static_cast<int>(t.avgDepthMm + 0.5f));
+            bool wasConfirmed = t.confirmed;
+            if (!t.confirmed && t.hits >= confirmFrames_) confirm(t, frameCount, ms);
+            if (gestures_.enabled && t.confirmed)
+                t.gesture.sample(gestures_, t.band, t.serial, b.cx, b.cy, t.motion.vel[0],
+                                 t.motion.vel[1], ms, events_);
+            if (!wasConfirmed) continue;
+            eventLog().push(LogEventType::CursorMove, LogLevel::Debug, frameCount, ms, t.serial, t.cx,
+                            t.cy, static_cast<int>(t.avgDepthMm + 0.5f));
         }
 
-        // Unmatched active blobs -> ended
-        // Remove in reverse order to keep indices valid
-        for (int a = static_cast<int>(active_.size()) - 1; a >= 0; a--) {
-            if (!activeMatched[a]) {
-                std::printf("[%6d %7lldms] Cursor end #%d\n",
-                            frameCount, ms, active_[a].serial);
-                active_.erase(active_.begin() + a);
+        // Unmatched active blobs: confirmed tracks coast on their prediction for
+        // up to coastFrames_, keeping their id through dropped frames; tentative
+        // ones and tracks out of grace end. Compact the survivors in one pass.
+        size_t kept = 0;
+        for (size_t a = 0; a < active_.size(); a++) {
+            auto& t = active_[a];
+            if (!activeMatched_[a]) {
+                if (!t.confirmed || t.misses >= coastFrames_ + t.grace) {
+                    if (t.confirmed) {
+                        eventLog().push(LogEventType::CursorEnd, LogLevel::Info, frameCount, ms, t.serial);
+                        if (gestures_.enabled)
+                            t.gesture.end(gestures_, t.band, t.serial, t.centroidX, t.centroidY, ms, events_);
+                    }
+                    history_.release(t.historySlot);
+                    continue;
+                }
+                t.misses++;
+                coast(t);
             }
+            if (kept != a) active_[kept] = std::move(t);
+            kept++;
         }
+        active_.resize(kept);
 
         // Unmatched incoming blobs -> new
-        for (size_t n = 0; n < incoming.size(); n++) {
-            if (!incomingMatched[n]) {
-                const auto& inc = incoming[n];
-                const auto& b = blobs[inc.idx];
-                TrackedBlob t;
-                t.serial = nextSerial_++;
+        for (size_t n = 0; n < incoming_.size(); n++) {
+            if (!incomingMatched_[n]) {
+                const auto& inc = incoming_[n];
+                auto& b = blobs[inc.idx];
+                active_.emplace_back();
+                TrackedBlob& t = active_.back();
+                t.serial = 0;
                 t.cx = inc.cx;
                 t.cy = inc.cy;
-                t.pixelCount = b.pixelCount;
-                t.avgDepthMm = b.avgDepthMm;
-                t.maxDepthMm = b.maxDepthMm;
-                active_.push_back(t);
-
-                std::printf("[%6d %7lldms] Cursor start #%d at (%d, %d) %dmm\n",
-                            frameCount, ms, t.serial, t.cx, t.cy,
-                            static_cast<int>(t.avgDepthMm + 0.5f));
+                assignMeasurement(t, b);
+                t.nextTipId = 1;
+                matchTips(t, b.tips);
+                t.motion.init(b.cx, b.cy);
+                t.confirmed = false;
+                t.hits = 1;
+                t.misses = 0;
+                t.grace = 0;
+                t.historySlot = history_.acquire();
+                record(t, ms);
+                t.gesture.start(b.cx, b.cy, ms);
+                if (confirmFrames_ <= 1) confirm(t, frameCount, ms);
             }
         }
+
+        if (gestures_.enabled) updatePinch(ms);
+    }
+
+    // Gestures recognized during the last update (see gestures.hpp)
+    const std::vector<GestureEvent>& gestureEvents() const { return events_; }
+    void setGestures(const GestureSettings& s) {
+        gestures_ = s;
+        pinch_.reset();
     }
 
+    // All live tracks, including tentative ones (confirmed == false) that the
+    // blob outputs skip.
     const std::vector<TrackedBlob>& activeBlobs() const { return active_; }
 
+    // Append the recent path (oldest first) of every published track to out,
+    // tagged with the layer's band.
+    void snapshotHistory(int band, TrackHistorySnapshot& out) const {
+        for (const auto& t : active_) {
+            if (!t.confirmed) continue;
+            int n = history_.size(t.historySlot);
+            out.tracks.push_back({band, t.serial, out.samples.size(), static_cast<size_t>(n)});
+            for (int i = 0; i < n; i++) out.samples.push_back(history_.at(t.historySlot, i));
+        }
+    }
+
+    // Save the next serial and the published tracks into state (storage is reused).
+    void saveState(TrackerState& state) const {
+        state.nextSerial = nextSerial_;
+        state.tracks.clear();
+        for (const auto& t : active_) {
+            if (!t.confirmed) continue;
+            state.tracks.push_back({t.serial, t.centroidX, t.centroidY, t.motion.vel[0], t.motion.vel[1],
+                                    t.avgDepthMm, t.pixelCount, t.zone, t.band});
+        }
+    }
+
+    // Continue from a saved state, e.g. in the first frame after a pipeline
+    // restart: serials carry on and the saved tracks come back as confirmed
+    // tracks that keep their ids if a blob shows up near them within
+    // kRestoreGraceFrames (plus the coast frames), else they end as usual.
+    // Positions are scaled by (sx, sy) for a changed resolution. The velocity
+    // is stale after the gap, so they restart at rest with a wide gate.
+    void restoreState(const TrackerState& state, float sx, float sy, long long ms) {
+        if (state.nextSerial > nextSerial_) nextSerial_ = state.nextSerial;
+        for (const auto& s : state.tracks) {
+            active_.emplace_back();
+            TrackedBlob& t = active_.back();
+            t.serial = s.serial;
+            t.centroidX = t.depthCx = s.x * sx;
+            t.centroidY = t.depthCy = s.y * sy;
+            t.cx = static_cast<int>(t.centroidX + 0.5f);
+            t.cy = static_cast<int>(t.centroidY + 0.5f);
+            t.pixelCount = s.pixelCount;
+            t.avgDepthMm = s.depthMm;
+            t.zone = s.zone;
+            t.band = s.band;
+            t.nextTipId = 1;
+            t.motion.init(t.centroidX, t.centroidY);
+            t.confirmed = true;
+            t.hits = confirmFrames_;
+            t.misses = 0;
+            t.grace = kRestoreGraceFrames;
+            t.historySlot = history_.acquire();
+            record(t, ms);
+            t.gesture.resume(t.centroidX, t.centroidY, ms);
+        }
+    }
+
+    // Metric gate: the minimum match radius is gateMm at each track's own
+    // depth (projected with the focal length fx, px), and matches are scored in
+    // mm^2, so gating means the same thing for near and far hands and at any
+    // resolution; the widest gate scales with the frame width. gateMm <= 0 (or
+    // no focal length) keeps the fixed kMatchRadius pixel gate.
+    void setMatchGate(float gateMm, float fx, int width) {
+        if (gateMm <= 0.0f || fx <= 0.0f || width <= 0) {
+            gateMm_ = 0.0f;
+            maxGateRadius_ = kMaxGateRadius;
+            return;
+        }
+        gateMm_ = gateMm;
+        gateFx_ = fx;
+        maxGateRadius_ = kMaxGateRadius * width / kReferenceWidth;
+        if (maxGateRadius_ < kMaxGateRadius) maxGateRadius_ = kMaxGateRadius;
+    }
+
+    // A new track is published once it has been matched in confirmFrames
+    // consecutive frames (1 = immediately); a confirmed track that loses its
+    // blob coasts on the prediction for up to coastFrames frames before it
+    // ends, so a dropped depth frame doesn't turn into an end + start.
+    void setLifecycle(int confirmFrames, int coastFrames) {
+        if (confirmFrames < 1) confirmFrames = 1;
+        if (confirmFrames > kMaxLifecycleFrames) confirmFrames = kMaxLifecycleFrames;
+        if (coastFrames < 0) coastFrames = 0;
+        if (coastFrames > kMaxLifecycleFrames) coastFrames = kMaxLifecycleFrames;
+        confirmFrames_ = confirmFrames;
+        coastFrames_ = coastFrames;
+    }
+
+    // Greedy closest-first matching (default) or the globally optimal
+    // assignment, which keeps ids from swapping when blobs cross (assignment.hpp).
+    void setOptimalAssignment(bool on) { optimal_ = on; }
+
 private:
-    static constexpr int kMatchRadius = 80;
-    static constexpr int kMatchRadiusSq = kMatchRadius * kMatchRadius;
+    // Copy a detection's measurements (everything but id, motion and tips) into
+    // a track; the contour is swapped out of b rather than copied
+    static void assignMeasurement(TrackedBlob& t, BlobInfo& b) {
+        t.centroidX = b.cx;
+        t.centroidY = b.cy;
+        t.depthCx = b.depthCx;
+        t.depthCy = b.depthCy;
+        t.angleDeg = b.angleDeg;
+        t.eccentricity = b.eccentricity;
+        t.pixelCount = b.pixelCount;
+        t.avgDepthMm = b.avgDepthMm;
+        t.maxDepthMm = b.maxDepthMm;
+        t.minDepthMm = b.minDepthMm;
+        t.minDepthX = b.minDepthX;
+        t.minDepthY = b.minDepthY;
+        t.p10Mm = b.p10Mm;
+        t.medianMm = b.medianMm;
+        t.p90Mm = b.p90Mm;
+        t.xMm = b.xMm;
+        t.yMm = b.yMm;
+        t.zMm = b.zMm;
+        t.zone = b.zone;
+        t.band = b.band;
+        t.contour.swap(b.contour);
+        t.defects = b.defects;
+        t.colorB = b.colorB;
+        t.colorG = b.colorG;
+        t.colorR = b.colorR;
+        t.hasColor = b.hasColor;
+    }
+
+    struct Incoming {
+        int cx, cy;
+        int idx;  // index into blobs vector
+    };
+
+    struct MatchPair {
+        int activeIdx;
+        int incomingIdx;
+        int distSq;     // match score: squared distance, px^2 (or mm^2 with a metric gate)
+    };
+
+    // Predicted position of an active track, its gate (squared radius, px) and
+    // the squared size of one pixel at the track's depth (mm^2, metric gate only)
+    struct Prediction {
+        int x, y;
+        int gateSq;
+        float mmPerPxSq;
+    };
+
+    // Pinch over the two measured, confirmed tracks when there are exactly two
+    void updatePinch(long long ms) {
+        const TrackedBlob* pair[2];
+        int n = 0;
+        for (const auto& t : active_) {
+            if (!t.confirmed || t.misses > 0) continue;
+            if (n == 2) { n = 3; break; }
+            pair[n++] = &t;
+        }
+        if (n != 2) {
+            pinch_.reset();
+            return;
+        }
+        if (pair[0]->serial > pair[1]->serial) std::swap(pair[0], pair[1]);
+        pinch_.update(gestures_, pair[0]->band, pair[0]->serial, pair[0]->centroidX, pair[0]->centroidY,
+                      pair[1]->serial, pair[1]->centroidX, pair[1]->centroidY, ms, events_);
+    }
+
+    void record(const TrackedBlob& t, long long ms) {
+        uint16_t d = static_cast<uint16_t>(t.avgDepthMm > 65535.0f ? 65535 : t.avgDepthMm + 0.5f);
+        history_.push(t.historySlot, {ms, t.centroidX, t.centroidY, d});
+    }
+
+    void confirm(TrackedBlob& t, int frameCount, long long ms) {
+        t.confirmed = true;
+        t.serial = nextSerial_++;
+        eventLog().push(LogEventType::CursorStart, LogLevel::Info, frameCount, ms, t.serial, t.cx, t.cy,
+                        static_cast<int>(t.avgDepthMm + 0.5f));
+    }
+
+    // Move an unmatched track to its predicted position (already advanced to
+    // this frame by predictTracks); everything else keeps its last measurement.
+    static void coast(TrackedBlob& t) {
+        float x = t.motion.pos[0], y = t.motion.pos[1];
+        if (x < 0.0f) x = 0.0f;
+        if (y < 0.0f) y = 0.0f;
+        t.centroidX = x;
+        t.centroidY = y;
+        t.cx = static_cast<int>(x + 0.5f);
+        t.cy = static_cast<int>(y + 0.5f);
+    }
+
+    // Seconds since the previous update (a nominal frame on the first one or
+    // after a stall).
+    float frameDt(long long ms) {
+        float dt = kDefaultDt;
+        if (lastMs_ >= 0 && ms > lastMs_) dt = (ms - lastMs_) / 1000.0f;
+        if (dt > kMaxDt) dt = kMaxDt;
+        lastMs_ = ms;
+        return dt;
+    }
+
+    // The gate is the predicted position's 99% confidence radius (innovation
+    // covariance), never smaller than the minimum radius: a fresh track, whose
+    // velocity is still unknown, gets a wide gate, a steady one a tight gate
+    // around where it is heading. The minimum is kMatchRadius pixels, or with a
+    // metric gate gateMm_ at the track's depth (near blobs get a wider gate).
+    void predictTracks(float dt) {
+        pred_.resize(active_.size());
+        maxGate_ = 1;
+        maxScore_ = 1;
+        for (size_t a = 0; a < active_.size(); a++) {
+            const TrackedBlob& t = active_[a];
+            BlobKalman& k = active_[a].motion;
+            k.predict(dt);
+            float minR = kMatchRadius, mmPerPx = 1.0f;
+            if (gateMm_ > 0.0f) {
+                float z = t.avgDepthMm > 0.0f ? t.avgDepthMm : kFallbackDepthMm;
+                mmPerPx = z / gateFx_;
+                minR = gateMm_ / mmPerPx;
+                if (minR < kMinGateRadius) minR = kMinGateRadius;
+            }
+            float r = std::sqrt(kGateChi2 * k.innovationVar());
+            if (r < minR) r = minR;
+            if (r > maxGateRadius_) r = static_cast<float>(maxGateRadius_);
+            int gate = static_cast<int>(r);
+            Prediction& p = pred_[a];
+            p = {static_cast<int>(std::lround(k.pos[0])), static_cast<int>(std::lround(k.pos[1])),
+                 gate * gate, mmPerPx * mmPerPx};
+            if (gate > maxGate_) maxGate_ = gate;
+            int s = score(p, p.gateSq);
+            if (s > maxScore_) maxScore_ = s;
+        }
+        // Radix keys are the scores shifted down to 16 bits (a no-op for pixel gates)
+        scoreShift_ = 0;
+        while ((maxScore_ >> scoreShift_) >= (1 << 16)) scoreShift_++;
+    }
+
+    int score(const Prediction& p, int dsq) const {
+        if (gateMm_ <= 0.0f) return dsq;
+        return static_cast<int>(dsq * p.mmPerPxSq + 0.5f);
+    }
+
+    // Fill sorted_ with all (active, incoming) pairs inside the track's gate,
+    // by increasing distance to the prediction. Predictions are bucketed into a
+    // uniform grid with cells as large as the widest gate, so each incoming
+    // blob only looks at the 3x3 cells around it; the pairs are then
+    // radix-sorted on their score. Both
+    // steps are linear in the number of blobs and pairs, and all storage is
+    // kept between frames.
+    void buildCandidates() {
+        candidates_.clear();
+        sorted_.clear();
+        if (active_.empty() || incoming_.empty()) return;
+
+        const int cell = maxGate_;
+        int minX = pred_[0].x, minY = pred_[0].y, maxX = minX, maxY = minY;
+        for (const auto& p : pred_) {
+            if (p.x < minX) minX = p.x;
+            if (p.x > maxX) maxX = p.x;
+            if (p.y < minY) minY = p.y;
+            if (p.y > maxY) maxY = p.y;
+        }
+        int cols = (maxX - minX) / cell + 1;
+        int rows = (maxY - minY) / cell + 1;
+
+        // Counting sort of the active blobs by cell: cellStart_[c]..cellStart_[c + 1]
+        cellStart_.assign(static_cast<size_t>(cols) * rows + 1, 0);
+        cellItems_.resize(active_.size());
+        auto cellOf = [&](int x, int y) {
+            return ((y - minY) / cell) * cols + (x - minX) / cell;
+        };
+        for (const auto& p : pred_) cellStart_[cellOf(p.x, p.y) + 1]++;
+        for (size_t c = 1; c < cellStart_.size(); c++) cellStart_[c] += cellStart_[c - 1];
+        cellFill_.assign(cellStart_.begin(), cellStart_.end() - 1);
+        for (size_t a = 0; a < active_.size(); a++)
+            cellItems_[cellFill_[cellOf(pred_[a].x, pred_[a].y)]++] = static_cast<int>(a);
+
+        for (size_t n = 0; n < incoming_.size(); n++) {
+            const auto& inc = incoming_[n];
+            // Cell coordinates; floor division so blobs left of / above the grid map outside it
+            int gx = inc.cx - minX, gy = inc.cy - minY;
+            gx = gx >= 0 ? gx / cell : -1 - (-gx - 1) / cell;
+            gy = gy >= 0 ? gy / cell : -1 - (-gy - 1) / cell;
+            for (int cy = gy - 1; cy <= gy + 1; cy++) {
+                if (cy < 0 || cy >= rows) continue;
+                for (int cx = gx - 1; cx <= gx + 1; cx++) {
+                    if (cx < 0 || cx >= cols) continue;
+                    int c = cy * cols + cx;
+                    for (int k = cellStart_[c]; k < cellStart_[c + 1]; k++) {
+                        int a = cellItems_[k];
+                        int dx = pred_[a].x - inc.cx;
+                        int dy = pred_[a].y - inc.cy;
+                        int dsq = dx * dx + dy * dy;
+                        if (dsq <= pred_[a].gateSq)
+                            candidates_.push_back({a, static_cast<int>(n), score(pred_[a], dsq)});
+                    }
+                }
+            }
+        }
+
+        // LSD radix sort on the 16-bit score key, two 8-bit passes (stable)
+        static_assert(kMaxGateRadius * kMaxGateRadius < (1 << 16), "pixel scores must fit the two radix passes");
+        sorted_.resize(candidates_.size());
+        for (int shift = scoreShift_; shift < scoreShift_ + 16; shift += 8) {
+            int count[257] = {};
+            for (const auto& m : candidates_) count[((m.distSq >> shift) & 0xFF) + 1]++;
+            for (int b = 1; b < 257; b++) count[b] += count[b - 1];
+            for (const auto& m : candidates_) sorted_[count[(m.distSq >> shift) & 0xFF]++] = m;
+            if (shift == scoreShift_) candidates_.swap(sorted_);
+        }
+    }
+
+    // Closest pair first; a blob already taken is skipped
+    void assignGreedy() {
+        for (const auto& m : sorted_) {
+            if (activeMatched_[m.activeIdx] || incomingMatched_[m.incomingIdx]) continue;
+            activeMatched_[m.activeIdx] = 1;
+            incomingMatched_[m.incomingIdx] = 1;
+            matches_.push_back(m);
+        }
+    }
+
+    // Minimum total score (squared distance to the predictions) over the gated
+    // pairs; leaving a blob unmatched costs the widest gate, so every gated
+    // pair is preferred over splitting it into an end and a start.
+    void assignOptimal() {
+        edges_.clear();
+        for (const auto& m : sorted_) edges_.push_back({m.activeIdx, m.incomingIdx, m.distSq});
+        assigner_.solve(static_cast<int>(active_.size()), static_cast<int>(incoming_.size()),
+                        edges_, maxScore_, matchA_);
+        for (size_t a = 0; a < matchA_.size(); a++) {
+            int n = matchA_[a];
+            if (n < 0) continue;
+            activeMatched_[a] = 1;
+            incomingMatched_[n] = 1;
+            int dx = pred_[a].x - incoming_[n].cx;
+            int dy = pred_[a].y - incoming_[n].cy;
+            matches_.push_back({static_cast<int>(a), n, score(pred_[a], dx * dx + dy * dy)});
+        }
+    }
+
+    // Carry tip ids over from the previous frame: each new tip takes the id of
+    // the closest unclaimed previous tip within kTipMatchRadius, else a fresh id.
+    void matchTips(TrackedBlob& t, const std::vector<BlobTip>& tips) {
+        uint32_t claimed = 0;   // bitmask over previous tips (at most a handful)
+        for (size_t i = 0; i < tips.size(); i++) {
+            int best = -1;
+            int bestD = kTipMatchRadius * kTipMatchRadius;
+            for (size_t j = 0; j < t.tips.size() && j < 32; j++) {
+                if (claimed & (1u << j)) continue;
+                int dx = tips[i].x - t.tips[j].x;
+                int dy = tips[i].y - t.tips[j].y;
+                if (dx * dx + dy * dy <= bestD) { bestD = dx * dx + dy * dy; best = static_cast<int>(j); }
+            }
+            int id;
+            if (best >= 0) {
+                claimed |= 1u << best;
+                id = t.tips[best].id;
+            } else {
+                id = t.nextTipId++;
+            }
+            tipScratch_.push_back(tips[i]);
+            tipScratch_.back().id = id;
+        }
+        t.tips.swap(tipScratch_);
+        tipScratch_.clear();
+    }
+
+    static constexpr int kTipMatchRadius = 20;
+    static constexpr int kMatchRadius = 80;       // minimum gate around the prediction (pixel gate)
+    static constexpr int kMaxGateRadius = 240;    // at kReferenceWidth
+    static constexpr int kReferenceWidth = 640;
+    static constexpr float kMinGateRadius = 8.0f;
+    static constexpr float kFallbackDepthMm = 800.0f;   // metric gate for blobs without valid depth
+    static constexpr float kGateChi2 = 9.21f;     // 99% for 2 degrees of freedom
+    static constexpr float kDefaultDt = 1.0f / 30.0f;
+    static constexpr float kMaxDt = 0.25f;
+    static constexpr int kMaxLifecycleFrames = 30;
+    static constexpr int kRestoreGraceFrames = 15;
 
     std::vector<TrackedBlob> active_;
+    TrajectoryPool history_;
+    GestureSettings gestures_;
+    std::vector<GestureEvent> events_;
+    PinchTracker pinch_;
+    std::vector<BlobTip> tipScratch_;
+
+    // Matching storage, reused across frames
+    std::vector<Incoming> incoming_;
+    std::vector<MatchPair> candidates_;
+    std::vector<MatchPair> sorted_;
+    std::vector<uint8_t> activeMatched_;
+    std::vector<uint8_t> incomingMatched_;
+    std::vector<int> cellStart_;
+    std::vector<int> cellFill_;
+    std::vector<int> cellItems_;
+    std::vector<MatchPair> matches_;
+    std::vector<AssignEdge> edges_;
+    std::vector<int> matchA_;
+    SparseAssignment assigner_;
+    std::vector<Prediction> pred_;
+    int maxGate_ = kMatchRadius;
+    int maxScore_ = 1;
+    int scoreShift_ = 0;
+    float gateMm_ = 0.0f;        // 0 = fixed pixel gate
+    float gateFx_ = 1.0f;
+    int maxGateRadius_ = kMaxGateRadius;
+    long long lastMs_ = -1;
+    bool optimal_ = false;
+    int confirmFrames_ = 1;
+    int coastFrames_ = 0;
     int nextSerial_ = 1;
 };
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// Blob outlines: Moore-neighbor border following on the label image, then
+// Douglas-Peucker simplification. Tracing only walks the boundary, so the cost
+// of a blob's contour scales with its perimeter, not its area.
+
+struct ContourPoint {
+    int16_t x, y;
+};
+
+// Trace the outer border of the 8-connected component whose pixels have
+// labels[i] == label, starting at its first pixel in raster order (startX, startY).
+// Points are appended clockwise (image coordinates, y down) without repeating
+// the start point. maxPoints bounds the walk for safety.
+inline void traceContour(const int* labels, int width, int height, int label,
+                         int startX, int startY, std::vector<ContourPoint>& out,
+                         int maxPoints = 1 << 16) {
+    // Clockwise directions in image coordinates: E, SE, S, SW, W, NW, N, NE
+    static const int kDx[8] = {1, 1, 0, -1, -1, -1, 0, 1};
+    static const int kDy[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+    auto inside = [&](int x, int y) {
+        return x >= 0 && y >= 0 && x < width && y < height && labels[y * width + x] == label;
+    };
+
+    out.clear();
+    out.push_back({static_cast<int16_t>(startX), static_cast<int16_t>(startY)});
+
+    int x = startX, y = startY;
+    int dir = 6;            // as if we arrived heading N: first search starts at NW
+    int firstDir = -1;
+    while (static_cast<int>(out.size()) < maxPoints) {
+        // Start the clockwise search just past the last background neighbor the
+        // previous search saw: d - 2 after a straight step, d - 3 after a diagonal
+        int s = (dir + 7 - (dir & 1)) & 7;
+        int nd = -1;
+        for (int k = 0; k < 8; k++) {
+            int d = (s + k) & 7;
+            if (inside(x + kDx[d], y + kDy[d])) { nd = d; break; }
+        }
+        if (nd < 0) break;                                      // isolated pixel
+        if (x == startX && y == startY && nd == firstDir) break;  // loop closed
+        if (firstDir < 0) firstDir = nd;
+        x += kDx[nd];
+        y += kDy[nd];
+        dir = nd;
+        out.push_back({static_cast<int16_t>(x), static_cast<int16_t>(y)});
+    }
+    if (out.size() > 1 && out.back().x == startX && out.back().y == startY) out.pop_back();
+}
+
+// Pending Douglas-Peucker split: the run (a, b) of a contour and its vertex
+// farthest from the chord a-b (squared distance d2).
+struct ContourSplit {
+    float d2;
+    int a, b, best;
+};
+
+// Douglas-Peucker simplification of a closed contour, in place.
+// Vertices closer than epsilon (px) to the simplified outline are dropped.
+// Splits are taken farthest first, so with maxVertices > 0 (at least 3) the
+// outline stops at that many vertices and keeps the ones that matter most;
+// with room to spare the result is plain Douglas-Peucker.
+// keep / heap are scratch buffers so repeated calls don't allocate.
+inline void simplifyContour(std::vector<ContourPoint>& pts, float epsilon,
+                            std::vector<uint8_t>& keep, std::vector<ContourSplit>& heap,
+                            int maxVertices = 0) {
+    int n = static_cast<int>(pts.size());
+    if (n <= 3) return;
+
+    // Split the closed loop at the start point and the point farthest from it
+    int far = 0;
+    int farD = -1;
+    for (int i = 1; i < n; i++) {
+        int dx = pts[i].x - pts[0].x, dy = pts[i].y - pts[0].y;
+        if (dx * dx + dy * dy > farD) { farD = dx * dx + dy * dy; far = i; }
+    }
+
+    keep.assign(n + 1, 0);
+    keep[0] = keep[far] = keep[n] = 1;
+    auto at = [&](int i) -> const ContourPoint& { return pts[i == n ? 0 : i]; };
+    float eps2 = epsilon * epsilon;
+
+    auto byDistance = [](const ContourSplit& l, const ContourSplit& r) { return l.d2 < r.d2; };
+    // Queue the run (a, b) if a vertex in it lies farther than epsilon from the chord
+    auto push = [&](int a, int b) {
+        if (b - a < 2) return;
+        const ContourPoint& pa = at(a);
+        const ContourPoint& pb = at(b);
+        float ex = static_cast<float>(pb.x - pa.x), ey = static_cast<float>(pb.y - pa.y);
+        float len2 = ex * ex + ey * ey;
+        int best = -1;
+        float bestD = eps2;
+        for (int i = a + 1; i < b; i++) {
+            float px = static_cast<float>(at(i).x - pa.x), py = static_cast<float>(at(i).y - pa.y);
+            float d2;
+            if (len2 > 0.0f) {
+                float cross = px * ey - py * ex;
+                d2 = cross * cross / len2;
+            } else {
+                d2 = px * px + py * py;
+            }
+            if (d2 > bestD) { bestD = d2; best = i; }
+        }
+        if (best < 0) return;
+        heap.push_back({bestD, a, b, best});
+        std::push_heap(heap.begin(), heap.end(), byDistance);
+    };
+
+    int limit = maxVertices > 0 ? std::max(3, maxVertices) : n;
+    int kept = 2;
+    heap.clear();
+    push(0, far);
+    push(far, n);
+    while (!heap.empty() && kept < limit) {
+        std::pop_heap(heap.begin(), heap.end(), byDistance);
+        ContourSplit s = heap.back();
+        heap.pop_back();
+        keep[s.best] = 1;
+        kept++;
+        push(s.a, s.best);
+        push(s.best, s.b);
+    }
+
+    int w = 0;
+    for (int i = 0; i < n; i++)
+        if (keep[i]) pts[w++] = pts[i];
+    pts.resize(w);
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <vector>
+
+#include "blobdetect.hpp"
+#include "intrinsics.hpp"
+
+// Metric (camera space, mm) positions for blobs: x right, y down, z along the
+// optical axis, as in plane.hpp. A pixel's ray is (colRay[x], rowRay[y], 1),
+// so a point at depth z is a table lookup and two multiplies. The tables are
+// rebuilt only when the intrinsics (i.e. resolution or calibration) change.
+class DepthRays {
+public:
+    void configure(const CameraIntrinsics& k) {
+        if (k.width == intr_.width && k.height == intr_.height && k.fx == intr_.fx &&
+            k.fy == intr_.fy && k.cx == intr_.cx && k.cy == intr_.cy)
+            return;
+        intr_ = k;
+        colRay_.clear();
+        rowRay_.clear();
+        if (!k.valid()) return;
+        // One extra entry on each table so sub-pixel lookups can interpolate at the edge
+        colRay_.resize(k.width + 1);
+        rowRay_.resize(k.height + 1);
+        for (int x = 0; x <= k.width; x++) colRay_[x] = (x - k.cx) / k.fx;
+        for (int y = 0; y <= k.height; y++) rowRay_[y] = (y - k.cy) / k.fy;
+    }
+
+    bool valid() const { return !colRay_.empty(); }
+    const CameraIntrinsics& intrinsics() const { return intr_; }
+
+    // Point at integer pixel (x, y) and depth z (mm).
+    void pixel(int x, int y, float z, float& X, float& Y) const {
+        X = colRay_[x] * z;
+        Y = rowRay_[y] * z;
+    }
+
+    // Point at sub-pixel position (u, v), clamped to the frame, and depth z (mm).
+    void point(float u, float v, float z, float& X, float& Y) const {
+        X = lookup(colRay_, u, intr_.width) * z;
+        Y = lookup(rowRay_, v, intr_.height) * z;
+    }
+
+    // Fill the metric position of each blob and its tips. The blob position is
+    // the ray through the depth-weighted centroid scaled by the average depth,
+    // which is exactly the mean of the blob's 3D points (sum of (u - cx) * d /
+    // fx over the pixels, divided by their count).
+    void apply(std::vector<BlobInfo>& blobs) const {
+        if (!valid()) return;
+        for (auto& b : blobs) {
+            b.zMm = b.avgDepthMm;
+            point(b.depthCx, b.depthCy, b.zMm, b.xMm, b.yMm);
+            for (auto& t : b.tips) {
+                t.zMm = t.depthMm;
+                pixel(t.x, t.y, t.zMm, t.xMm, t.yMm);
+            }
+        }
+    }
+
+private:
+    static float lookup(const std::vector<float>& table, float u, int size) {
+        if (u < 0.0f) u = 0.0f;
+        if (u > size - 1) u = static_cast<float>(size - 1);
+        int i = static_cast<int>(u);
+        return table[i] + (u - i) * (table[i + 1] - table[i]);
+    }
+
+    CameraIntrinsics intr_;
+    std::vector<float> colRay_;
+    std::vector<float> rowRay_;
+};
@@ -2,8 +2,11 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <vector>
 
+#include "roimask.hpp"
+
 // Turbo colormap LUT (256 entries, RGB)
 // Approximation of the Turbo colormap: blue -> cyan -> green -> yellow -> red
 inline void turboRgb(uint8_t idx, uint8_t& r, uint8_t& g, uint8_t& b) {
@@ -61,13 +64,69 @@ inline void depthToColorBgr(const uint16_t* depthMm, int width, int height,
     }
 }
 
+// Mask value for "weak" foreground written by the hysteresis threshold.
+// Weak pixels only survive labeling when connected to a strong (black) pixel;
+// detectAndDrawBlobs repaints them black or white as it resolves components.
+constexpr uint8_t kWeakForeground = 128;
+
+// Foreground of a thresholded mask, one byte per pixel: 1 = black, 2 = weak
+// (kWeakForeground), 0 = background. Taken before blob labeling draws its
+// rectangles over the mask; resolveForegroundMask then settles the weak pixels.
+inline void foregroundMask(const uint8_t* bgr, int count, uint8_t* mask) {
+    for (int i = 0; i < count; i++) {
+        const uint8_t* p = bgr + i * 3;
+        uint8_t v = p[0];
+        mask[i] = (v == 0 || v == kWeakForeground) && p[1] == v && p[2] == v
+                      ? (v == 0 ? 1 : 2) : 0;
+    }
+}
+
+// After labeling: weak pixels are foreground unless labeling repainted them
+// white (a weak-only component); rectangles drawn over them don't count.
+inline void resolveForegroundMask(const uint8_t* bgr, int count, uint8_t* mask) {
+    for (int i = 0; i < count; i++) {
+        if (mask[i] != 2) continue;
+        const uint8_t* p = bgr + i * 3;
+        mask[i] = (p[0] & p[1] & p[2]) != 255;
+    }
+}
+
 // Threshold depth to black/white. Closer than thresholdMm -> black, farther -> white.
 // Depth 0 (invalid/no data) -> white.
+// If hysteresisMm > 0, pixels in [thresholdMm, thresholdMm + hysteresisMm) are
+// written as weak foreground (kWeakForeground gray) instead of white.
+// If roi is given (and not full-frame), only the active spans are thresholded;
+// everything outside the region is written white (background).
 inline void depthToThresholdBgr(const uint16_t* depthMm, int width, int height,
-                                 uint8_t* outBgr, uint16_t thresholdMm) {
+                                 uint8_t* outBgr, uint16_t thresholdMm,
+                                 const RoiSpans* roi = nullptr,
+                                 uint16_t hysteresisMm = 0) {
+    uint16_t weakMm = static_cast<uint16_t>(std::min(65535, thresholdMm + hysteresisMm));
+    auto classify = [&](uint16_t d) -> uint8_t {
+        if (d == 0 || d >= weakMm) return 255;
+        return d < thresholdMm ? 0 : kWeakForeground;
+    };
+
+    if (roi && !roi->full) {
+        std::memset(outBgr, 255, static_cast<size_t>(width) * height * 3);
+        for (int y = 0; y < height; y++) {
+            for (int s = roi->rowBegin(y); s < roi->rowEnd(y); s++) {
+                const Span& sp = roi->spans[s];
+                int i = y * width + sp.x0;
+                for (int x = sp.x0; x < sp.x1; x++, i++) {
+                    uint8_t val = classify(depthMm[i]);
+                    int outIdx = i * 3;
+                    outBgr[outIdx + 0] = val;
+                    outBgr[outIdx + 1] = val;
+                    outBgr[outIdx + 2] = val;
+                }
+            }
+        }
+        return;
+    }
+
     for (int i = 0; i < width * height; i++) {
-        uint16_t d = depthMm[i];
-        uint8_t val = (d > 0 && d < thresholdMm) ? 0 : 255;
+        uint8_t val = classify(depthMm[i]);
         int outIdx = i * 3;
         outBgr[outIdx + 0] = val;
         outBgr[outIdx + 1] = val;
@@ -78,36 +137,60 @@ inline void depthToThresholdBgr(const uint16_t* depthMm, int width, int height,
 // Dilate the binary (black=foreground, white=background) BGR image in-place.
 // Uses a 3x3 square structuring element. Each iteration expands black regions
 // by one pixel in all 8 directions. Useful for connecting nearby blobs.
-inline void dilateBinaryBgr(uint8_t* bgr, int width, int height, int iterations) {
+// If roi is given, only pixels inside the active spans are visited, so
+// foreground never grows into cropped or excluded areas.
+inline void dilateBinaryBgr(uint8_t* bgr, int width, int height, int iterations,
+                            const RoiSpans* roi = nullptr) {
     if (iterations <= 0) return;
     int total = width * height;
-    std::vector<uint8_t> temp(total);
+    bool useSpans = roi && !roi->full;
+    std::vector<uint8_t> temp(total, 255);
+
+    // Dilate a single pixel if any 3x3 neighbor in temp is foreground
+    auto dilatePixel = [&](int x, int y) {
+        int idx = y * width + x;
+        if (temp[idx] == 0) return;  // already foreground, skip
+
+        // Check 3x3 neighborhood for any black (foreground) pixel
+        bool hasBlack = false;
+        for (int dy = -1; dy <= 1 && !hasBlack; dy++) {
+            int ny = y + dy;
+            if (ny < 0 || ny >= height) continue;
+            for (int dx = -1; dx <= 1 && !hasBlack; dx++) {
+                int nx = x + dx;
+                if (nx < 0 || nx >= width) continue;
+                if (temp[ny * width + nx] == 0) hasBlack = true;
+            }
+        }
+        if (hasBlack) {
+            int bi = idx * 3;
+            bgr[bi] = bgr[bi + 1] = bgr[bi + 2] = 0;
+        }
+    };
 
     for (int iter = 0; iter < iterations; iter++) {
+        if (useSpans) {
+            // Pixels outside the spans stay 255 in temp from the initial fill
+            for (int y = 0; y < height; y++) {
+                for (int s = roi->rowBegin(y); s < roi->rowEnd(y); s++) {
+                    const Span& sp = roi->spans[s];
+                    for (int x = sp.x0; x < sp.x1; x++) temp[y * width + x] = bgr[(y * width + x) * 3];
+                }
+            }
+            for (int y = 0; y < height; y++) {
+                for (int s = roi->rowBegin(y); s < roi->rowEnd(y); s++) {
+                    const Span& sp = roi->spans[s];
+                    for (int x = sp.x0; x < sp.x1; x++) dilatePixel(x, y);
+                }
+            }
+            continue;
+        }
+
         // Extract single channel (all channels identical for binary image)
         for (int i = 0; i < total; i++) temp[i] = bgr[i * 3];
 
         for (int y = 0; y < height; y++) {
-            for (int x = 0; x < width; x++) {
-                int idx = y * width + x;
-                if (temp[idx] == 0) continue;  // already foreground, skip
-
-                // Check 3x3 neighborhood for any black (foreground) pixel
-                bool hasBlack = false;
-                for (int dy = -1; dy <= 1 && !hasBlack; dy++) {
-                    int ny = y + dy;
-                    if (ny < 0 || ny >= height) continue;
-                    for (int dx = -1; dx <= 1 && !hasBlack; dx++) {
-                        int nx = x + dx;
-                        if (nx < 0 || nx >= width) continue;
-                        if (temp[ny * width + nx] == 0) hasBlack = true;
-                    }
-                }
-                if (hasBlack) {
-                    int bi = idx * 3;
-                    bgr[bi] = bgr[bi + 1] = bgr[bi + 2] = 0;
-                }
-            }
+            for (int x = 0; x < width; x++) dilatePixel(x, y);
         }
     }
 }
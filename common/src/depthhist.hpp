@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstdint>
+
+// Compact per-blob depth histogram, filled one pixel at a time while labeling.
+// 64 bins whose width (a power of two, in mm) adapts to the blob's own depth
+// spread: the range starts 1 mm wide at the first sample and doubles (merging
+// bin pairs) whenever a sample falls outside it. A hand spanning 100 mm ends up
+// with 2 mm bins, whatever the threshold or plane mode. Percentiles are read
+// back with linear interpolation inside a bin, so no per-blob pixel lists are
+// stored or sorted.
+struct DepthHistogram {
+    static constexpr int kBins = 64;
+    static constexpr int kMaxShift = 10;   // 64 bins x 1024 mm covers every uint16 depth
+
+    uint32_t bins[kBins] = {};
+    uint32_t total = 0;
+    uint32_t base = 0;      // lower edge of bin 0 (mm), a multiple of the bin width
+    int shift = 0;          // bin width = 1 << shift mm
+
+    void add(uint16_t depthMm) {
+        if (total == 0) {
+            base = depthMm;
+            shift = 0;
+        } else if (depthMm < base || ((depthMm - base) >> shift) >= static_cast<uint32_t>(kBins)) {
+            cover(depthMm, depthMm, shift);
+        }
+        bins[(depthMm - base) >> shift]++;
+        total++;
+    }
+
+    // Add another histogram's counts (e.g. the other half of a merged component).
+    void merge(const DepthHistogram& o) {
+        if (o.total == 0) return;
+        if (total == 0) {
+            *this = o;
+            return;
+        }
+        uint32_t oHi = o.base + (static_cast<uint32_t>(kBins) << o.shift) - 1;
+        cover(o.base, oHi, o.shift);
+        // Bins are power-of-two aligned and ours are at least as wide, so every
+        // bin of o falls inside exactly one of ours
+        for (int k = 0; k < kBins; k++) {
+            if (o.bins[k]) bins[(o.base + (static_cast<uint32_t>(k) << o.shift) - base) >> shift] += o.bins[k];
+        }
+        total += o.total;
+    }
+
+    // Depth (mm) below which fraction q of the samples lie; 0 when empty.
+    float percentile(float q) const {
+        if (total == 0) return 0.0f;
+        float target = q * total;
+        uint32_t cum = 0;
+        for (int k = 0; k < kBins; k++) {
+            if (!bins[k]) continue;
+            if (cum + bins[k] >= target) {
+                float frac = (target - cum) / bins[k];
+                return base + ((k + frac) * static_cast<float>(1u << shift));
+            }
+            cum += bins[k];
+        }
+        return static_cast<float>(base + (static_cast<uint32_t>(kBins) << shift));
+    }
+
+private:
+    // Widen the bins (at least to minShift) until [lo, hi] and the current range
+    // fit, re-binning the existing counts.
+    void cover(uint32_t lo, uint32_t hi, int minShift) {
+        uint32_t curHi = base + (static_cast<uint32_t>(kBins) << shift) - 1;
+        if (lo > base) lo = base;
+        if (hi < curHi) hi = curHi;
+
+        int s = shift > minShift ? shift : minShift;
+        uint32_t newBase = base;
+        for (; s <= kMaxShift; s++) {
+            newBase = lo & ~((1u << s) - 1);
+            if (newBase + (static_cast<uint32_t>(kBins) << s) > hi) break;
+        }
+        if (s > kMaxShift) {
+            s = kMaxShift;
+            newBase = 0;
+        }
+
+        uint32_t tmp[kBins] = {};
+        for (int k = 0; k < kBins; k++) {
+            if (bins[k]) tmp[(base + (static_cast<uint32_t>(k) << shift) - newBase) >> s] += bins[k];
+        }
+        for (int k = 0; k < kBins; k++) bins[k] = tmp[k];
+        base = newBase;
+        shift = s;
+    }
+};
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+
+// Asynchronous event log. The frame loop pushes fixed-size binary records into
+// a lock-free single-producer ring and never waits on stdout; a background
+// thread formats them, applies the level filter and a lines-per-second limit,
+// and optionally appends the raw records to a binary file. When the ring is
+// full records are dropped (and counted) rather than blocking the producer.
+//
+// Binary event log file: "DPL1", u32 record size, then LogRecord structs as
+// laid out below (host byte order, little-endian on all supported targets).
+
+enum class LogLevel : uint8_t { Debug = 0, Info, Warn, Off };
+
+enum class LogEventType : uint8_t {
+    Frame = 1,      // frame tick without blob detection
+    CursorStart,    // id, x, y, depth
+    CursorMove,
+    CursorEnd,      // id
+    Dropped,        // x = records lost to a full ring (file only)
+};
+
+struct LogRecord {
+    int64_t ms;
+    int32_t frame;
+    LogEventType type;
+    LogLevel level;
+    uint16_t reserved;
+    int32_t id;
+    int32_t x, y;
+    int32_t depthMm;
+};
+static_assert(sizeof(LogRecord) == 32, "LogRecord is a file format");
+
+inline bool parseLogLevel(const char* s, LogLevel& out) {
+    if (std::strcmp(s, "debug") == 0) out = LogLevel::Debug;
+    else if (std::strcmp(s, "info") == 0) out = LogLevel::Info;
+    else if (std::strcmp(s, "warn") == 0) out = LogLevel::Warn;
+    else if (std::strcmp(s, "off") == 0) out = LogLevel::Off;
+    else return false;
+    return true;
+}
+
+class EventLog {
+public:
+    ~EventLog() { stop(); }
+
+    // Start the writer thread. Text lines below level are skipped, at most
+    // maxLinesPerSec are printed (0 = no limit); with a binaryPath every
+    // record is also appended to that file.
+    void start(LogLevel level, int maxLinesPerSec, const std::string& binaryPath = {}) {
+        if (running_) return;
+        level_ = level;
+        maxLinesPerSec_ = maxLinesPerSec;
+        if (!binaryPath.empty()) {
+            file_ = std::fopen(binaryPath.c_str(), "wb");
+            if (file_) {
+                uint32_t size = sizeof(LogRecord);
+                std::fwrite("DPL1", 1, 4, file_);
+                std::fwrite(&size, 4, 1, file_);
+            } else {
+                std::fprintf(stderr, "Cannot open event log %s\n", binaryPath.c_str());
+            }
+        }
+        running_ = true;
+        thread_ = std::thread(&EventLog::run, this);
+    }
+
+    // Drain what is queued and stop the writer thread.
+    void stop() {
+        if (!running_) return;
+        running_ = false;
+        if (thread_.joinable()) thread_.join();
+        if (file_) {
+            std::fclose(file_);
+            file_ = nullptr;
+        }
+    }
+
+    // Cheap pre-check so callers can skip building a record nobody wants.
+    bool wants(LogLevel level) const { return running_ && (level >= level_ || file_); }
+
+    // Producer side: only the frame loop thread may push.
+    void push(const LogRecord& r) {
+        if (!wants(r.level)) return;
+        uint32_t h = head_.load(std::memory_order_relaxed);
+        if (h - tail_.load(std::memory_order_acquire) >= kCapacity) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        ring_[h & (kCapacity - 1)] = r;
+        head_.store(h + 1, std::memory_order_release);
+    }
+
+    void push(LogEventType type, LogLevel level, int frame, long long ms, int id = 0, int x = 0,
+              int y = 0, int depthMm = 0) {
+        push(LogRecord{ms, frame, type, level, 0, id, x, y, depthMm});
+    }
+
+private:
+    static constexpr uint32_t kCapacity = 4096;   // power of two
+    static constexpr size_t kLineBuffer = 64 * 1024;
+
+    void run() {
+        std::string out;
+        out.reserve(kLineBuffer);
+        auto windowStart = std::chrono::steady_clock::now();
+        int linesInWindow = 0, suppressed = 0;
+        for (;;) {
+            bool live = running_.load();
+            uint32_t t = tail_.load(std::memory_order_relaxed);
+            uint32_t h = head_.load(std::memory_order_acquire);
+            uint32_t lost = dropped_.exchange(0, std::memory_order_relaxed);
+            if (lost) {
+                out += "(" + std::to_string(lost) + " log records dropped, ring full)\n";
+                if (file_) {
+                    LogRecord d{0, 0, LogEventType::Dropped, LogLevel::Warn, 0, 0,
+                                static_cast<int32_t>(lost), 0, 0};
+                    std::fwrite(&d, sizeof(d), 1, file_);
+                }
+            }
+
+            bool last = !live && t == h;
+            auto now = std::chrono::steady_clock::now();
+            if (now - windowStart >= std::chrono::seconds(1) || last) {
+                if (suppressed)
+                    out += "(" + std::to_string(suppressed) + " log lines suppressed, rate limit)\n";
+                windowStart = now;
+                linesInWindow = suppressed = 0;
+            }
+
+            for (; t != h; t++) {
+                const LogRecord& r = ring_[t & (kCapacity - 1)];
+                if (file_) std::fwrite(&r, sizeof(r), 1, file_);
+                if (r.level < level_) continue;
+                if (maxLinesPerSec_ > 0 && linesInWindow >= maxLinesPerSec_) {
+                    suppressed++;
+                    continue;
+                }
+                linesInWindow++;
+                format(r, out);
+            }
+            tail_.store(t, std::memory_order_release);
+
+            if (!out.empty()) {
+                std::fwrite(out.data(), 1, out.size(), stdout);
+                std::fflush(stdout);
+                out.clear();
+            }
+            if (file_) std::fflush(file_);
+            if (last) break;
+            if (t == head_.load(std::memory_order_acquire))
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+
+    static void format(const LogRecord& r, std::string& out) {
+        char buf[128];
+        long long ms = r.ms;
+        switch (r.type) {
+        case LogEventType::Frame:
+            std::snprintf(buf, sizeof(buf), "[%6d %7lldms]\n", r.frame, ms);
+            break;
+        case LogEventType::CursorStart:
+            std::snprintf(buf, sizeof(buf), "[%6d %7lldms] Cursor start #%d at (%d, %d) %dmm\n",
+                          r.frame, ms, r.id, r.x, r.y, r.depthMm);
+            break;
+        case LogEventType::CursorMove:
+            std::snprintf(buf, sizeof(buf), "[%6d %7lldms] Cursor moved #%d to (%d, %d) %dmm\n",
+                          r.frame, ms, r.id, r.x, r.y, r.depthMm);
+            break;
+        case LogEventType::CursorEnd:
+            std::snprintf(buf, sizeof(buf), "[%6d %7lldms] Cursor end #%d\n", r.frame, ms, r.id);
+            break;
+        default:
+            return;
+        }
+        out += buf;
+    }
+
+    LogRecord ring_[kCapacity];
+    std::atomic<uint32_t> head_{0};   // next slot to write (producer)
+    std::atomic<uint32_t> tail_{0};   // next slot to read (writer thread)
+    std::atomic<uint32_t> dropped_{0};
+    std::atomic<bool> running_{false};
+    LogLevel level_ = LogLevel::Info;
+    int maxLinesPerSec_ = 0;
+    std::FILE* file_ = nullptr;
+    std::thread thread_;
+};
+
+// Process-wide log used by the trackers and frame loops.
+inline EventLog& eventLog() {
+    static EventLog log;
+    return log;
+}
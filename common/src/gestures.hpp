@@ -0,0 +1,189 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Gesture recognition over tracked blobs, run by BlobTracker on every update so
+// all clients see the same results. Each track carries a few floats of state
+// that are advanced once per measured sample, so the cost is constant per track
+// and frame:
+//   tap    a blob that appears and ends within tapMaxMs without moving more
+//          than stillRadiusPx
+//   hold   a blob that stays within stillRadiusPx for holdMs (fires once)
+//   swipe  the (filtered) speed exceeds swipeSpeed and the blob then travels
+//          swipeMinPx; direction is the dominant axis of that travel
+//   circle the direction of motion turns through a full revolution while
+//          moving; direction is clockwise or counter-clockwise on screen
+//   pinch  with exactly two blobs, every pinchStep change of their distance
+//          relative to when the pair formed (value = that ratio)
+enum class GestureType : uint8_t { Tap = 1, Hold, Swipe, Circle, Pinch };
+
+enum GestureDir : int8_t {
+    kDirNone = 0,
+    kSwipeLeft = 1, kSwipeRight, kSwipeUp, kSwipeDown,
+    kClockwise = 1, kCounterClockwise = -1,
+    kPinchIn = -1, kPinchOut = 1,
+};
+
+inline const char* gestureName(GestureType t) {
+    switch (t) {
+    case GestureType::Tap: return "tap";
+    case GestureType::Hold: return "hold";
+    case GestureType::Swipe: return "swipe";
+    case GestureType::Circle: return "circle";
+    case GestureType::Pinch: return "pinch";
+    }
+    return "";
+}
+
+struct GestureEvent {
+    GestureType type;
+    int8_t dir;          // GestureDir for swipe / circle / pinch
+    int band;
+    int id;              // track serial
+    int id2;             // second track (pinch), else 0
+    float x, y;          // where (px): the blob, or the midpoint of a pinch
+    float value;         // tap / hold: duration (ms); pinch: distance ratio; swipe: speed (px/s)
+    long long ms;
+};
+
+struct GestureSettings {
+    bool enabled = false;
+    int tapMaxMs = 250;
+    int holdMs = 600;
+    float stillRadiusPx = 15.0f;
+    float swipeSpeed = 600.0f;   // px/s
+    float swipeMinPx = 60.0f;
+    float pinchStep = 0.1f;      // relative distance change per pinch event
+};
+
+// Per-track recognizer state
+struct GestureTrack {
+    long long startMs;
+    long long lastMs;         // latest measured sample
+    float startX, startY;
+    float maxDispSq;     // farthest squared distance from the start
+    bool held;
+    bool swiping, swiped;
+    float anchorX, anchorY;   // where the current fast stroke began
+    float heading;            // direction of motion (rad), valid with hasHeading
+    bool hasHeading;
+    float turn;               // accumulated signed turning (rad)
+
+    void start(float x, float y, long long ms) {
+        startMs = lastMs = ms;
+        startX = x;
+        startY = y;
+        maxDispSq = 0.0f;
+        held = swiping = swiped = hasHeading = false;
+        anchorX = x;
+        anchorY = y;
+        heading = turn = 0.0f;
+    }
+
+    // Continue a track whose earlier samples are gone (restored after a
+    // restart): no tap or hold, swipes and circles start over.
+    void resume(float x, float y, long long ms) {
+        start(x, y, ms);
+        held = true;
+        maxDispSq = 1e30f;
+    }
+
+    // Advance with a measured sample (position and filtered velocity, px/s)
+    void sample(const GestureSettings& s, int band, int id, float x, float y, float vx, float vy,
+                long long ms, std::vector<GestureEvent>& out) {
+        lastMs = ms;
+        float dx = x - startX, dy = y - startY;
+        float dsq = dx * dx + dy * dy;
+        if (dsq > maxDispSq) maxDispSq = dsq;
+        float still = s.stillRadiusPx * s.stillRadiusPx;
+
+        if (!held && ms - startMs >= s.holdMs && maxDispSq <= still) {
+            held = true;
+            out.push_back({GestureType::Hold, kDirNone, band, id, 0, x, y,
+                           static_cast<float>(ms - startMs), ms});
+        }
+
+        float speed = std::sqrt(vx * vx + vy * vy);
+        if (speed >= s.swipeSpeed) {
+            if (!swiping) {
+                swiping = true;
+                anchorX = x;
+                anchorY = y;
+            }
+            float ax = x - anchorX, ay = y - anchorY;
+            if (!swiped && ax * ax + ay * ay >= s.swipeMinPx * s.swipeMinPx) {
+                swiped = true;
+                int8_t dir = std::fabs(ax) >= std::fabs(ay) ? (ax < 0 ? kSwipeLeft : kSwipeRight)
+                                                           : (ay < 0 ? kSwipeUp : kSwipeDown);
+                out.push_back({GestureType::Swipe, dir, band, id, 0, x, y, speed, ms});
+            }
+        } else if (speed < s.swipeSpeed * 0.5f) {
+            swiping = swiped = false;
+        }
+
+        // Turning of the direction of motion; slow or erratic motion resets it
+        if (speed < kCircleMinSpeed) {
+            hasHeading = false;
+            turn = 0.0f;
+            return;
+        }
+        float h = std::atan2(vy, vx);
+        if (hasHeading) {
+            float d = h - heading;
+            if (d > kPi) d -= 2.0f * kPi;
+            if (d < -kPi) d += 2.0f * kPi;
+            if (std::fabs(d) > kPi * 0.5f) turn = 0.0f;
+            else turn += d;
+            if (std::fabs(turn) >= 2.0f * kPi) {
+                // Image y points down, so increasing angles turn clockwise on screen
+                out.push_back({GestureType::Circle, turn > 0 ? kClockwise : kCounterClockwise,
+                               band, id, 0, x, y, 0.0f, ms});
+                turn = 0.0f;
+            }
+        }
+        heading = h;
+        hasHeading = true;
+    }
+
+    // The track ended (reported at ms; its duration ends at the last sample,
+    // so frames spent coasting don't count)
+    void end(const GestureSettings& s, int band, int id, float x, float y, long long ms,
+             std::vector<GestureEvent>& out) const {
+        if (lastMs - startMs <= s.tapMaxMs && maxDispSq <= s.stillRadiusPx * s.stillRadiusPx)
+            out.push_back({GestureType::Tap, kDirNone, band, id, 0, x, y,
+                           static_cast<float>(lastMs - startMs), ms});
+    }
+
+    static constexpr float kPi = 3.14159265f;
+    static constexpr float kCircleMinSpeed = 100.0f;   // px/s
+};
+
+// Two-hand pinch / zoom over the pair of tracks present when exactly two are
+struct PinchTracker {
+    int a = 0, b = 0;          // serials of the current pair (0 = none)
+    float startDist = 0.0f;
+    float lastRatio = 1.0f;    // ratio at the last event
+
+    void reset() { a = b = 0; }
+
+    void update(const GestureSettings& s, int band, int idA, float xa, float ya, int idB, float xb,
+                float yb, long long ms, std::vector<GestureEvent>& out) {
+        float dx = xb - xa, dy = yb - ya;
+        float dist = std::sqrt(dx * dx + dy * dy);
+        if (idA != a || idB != b) {
+            a = idA;
+            b = idB;
+            startDist = dist;
+            lastRatio = 1.0f;
+            return;
+        }
+        if (startDist < 1.0f) return;
+        float ratio = dist / startDist;
+        if (std::fabs(ratio - lastRatio) < s.pinchStep) return;
+        out.push_back({GestureType::Pinch, ratio > lastRatio ? kPinchOut : kPinchIn, band, idA, idB,
+                       (xa + xb) * 0.5f, (ya + yb) * 0.5f, ratio, ms});
+        lastRatio = ratio;
+    }
+};
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "contour.hpp"
+
+// Convex hull, convexity defects and extremity (fingertip) candidates of a
+// traced blob border (see contour.hpp). Everything works on the ordered border
+// points only, so a blob costs O(perimeter log perimeter), with no image pass.
+
+// An extremity point of a blob, e.g. a fingertip. id is assigned by the
+// tracker and stays with the tip while it keeps matching from frame to frame.
+struct BlobTip {
+    int16_t x, y;
+    uint16_t depthMm;   // depth at the tip (0 = no depth / invalid)
+    int id;
+    float xMm = 0.0f, yMm = 0.0f, zMm = 0.0f;   // camera-space position (see deproject.hpp)
+};
+
+// A concavity between two consecutive hull vertices: the border point farthest
+// inside the hull edge, and how far inside it is.
+struct ConvexityDefect {
+    int start, end;     // contour indices of the hull vertices bounding it
+    int farthest;       // contour index of the deepest point
+    float depth;        // distance from the hull edge (px)
+};
+
+// Monotone chain convex hull over the contour points. Writes the contour
+// indices of the hull vertices in contour order (collinear points dropped).
+// order is a scratch buffer.
+inline void convexHull(const std::vector<ContourPoint>& pts, std::vector<int>& hull,
+                       std::vector<int>& order) {
+    int n = static_cast<int>(pts.size());
+    hull.clear();
+    if (n < 3) {
+        for (int i = 0; i < n; i++) hull.push_back(i);
+        return;
+    }
+
+    order.resize(n);
+    for (int i = 0; i < n; i++) order[i] = i;
+    std::sort(order.begin(), order.end(), [&](int a, int b) {
+        return pts[a].x < pts[b].x || (pts[a].x == pts[b].x && pts[a].y < pts[b].y);
+    });
+
+    auto cross = [&](int o, int a, int b) {
+        return (pts[a].x - pts[o].x) * (pts[b].y - pts[o].y) -
+               (pts[a].y - pts[o].y) * (pts[b].x - pts[o].x);
+    };
+
+    // Lower then upper chain; hull holds indices, k is its current length
+    hull.resize(2 * n);
+    int k = 0;
+    for (int i = 0; i < n; i++) {
+        while (k >= 2 && cross(hull[k - 2], hull[k - 1], order[i]) <= 0) k--;
+        hull[k++] = order[i];
+    }
+    for (int i = n - 2, lower = k + 1; i >= 0; i--) {
+        while (k >= lower && cross(hull[k - 2], hull[k - 1], order[i]) <= 0) k--;
+        hull[k++] = order[i];
+    }
+    hull.resize(k > 1 ? k - 1 : k);   // last point repeats the first
+
+    // The border is a simple closed curve, so its hull vertices appear on it
+    // in hull order: sorting by contour index walks the hull along the border.
+    std::sort(hull.begin(), hull.end());
+}
+
+// Convexity defects deeper than minDepth between consecutive hull vertices
+// (hull in contour order, as produced by convexHull).
+inline void convexityDefects(const std::vector<ContourPoint>& pts, const std::vector<int>& hull,
+                             float minDepth, std::vector<ConvexityDefect>& out) {
+    out.clear();
+    int n = static_cast<int>(pts.size());
+    int h = static_cast<int>(hull.size());
+    if (h < 3) return;
+
+    for (int i = 0; i < h; i++) {
+        int a = hull[i];
+        int b = hull[(i + 1) % h];
+        int span = (b - a + n) % n;
+        if (span < 2) continue;
+
+        float ex = static_cast<float>(pts[b].x - pts[a].x);
+        float ey = static_cast<float>(pts[b].y - pts[a].y);
+        float len = std::sqrt(ex * ex + ey * ey);
+        if (len <= 0.0f) continue;
+
+        int best = -1;
+        float bestD = minDepth;
+        for (int s = 1; s < span; s++) {
+            int j = (a + s) % n;
+            float px = static_cast<float>(pts[j].x - pts[a].x);
+            float py = static_cast<float>(pts[j].y - pts[a].y);
+            float d = std::fabs(px * ey - py * ex) / len;
+            if (d > bestD) { bestD = d; best = j; }
+        }
+        if (best >= 0) out.push_back({a, b, best, bestD});
+    }
+}
+
+// Extremity candidates: hull vertices where the border turns sharply (the
+// angle between the points k steps before and after is below maxAngleDeg) and
+// that stick out beyond minDist from the centroid. Candidates closer than
+// mergeDist to a stronger one are merged. Writes up to maxTips contour indices,
+// farthest from the centroid first.
+inline void findExtremities(const std::vector<ContourPoint>& pts, const std::vector<int>& hull,
+                            float cx, float cy, float minDist, int k, float maxAngleDeg,
+                            float mergeDist, int maxTips, std::vector<int>& out,
+                            std::vector<std::pair<float, int>>& scratch) {
+    out.clear();
+    int n = static_cast<int>(pts.size());
+    if (maxTips <= 0 || n < 2 * k + 1) return;
+
+    float cosLimit = std::cos(maxAngleDeg * 3.14159265f / 180.0f);
+    scratch.clear();
+    for (int i : hull) {
+        const ContourPoint& p = pts[i];
+        float dx = p.x - cx, dy = p.y - cy;
+        float dist = std::sqrt(dx * dx + dy * dy);
+        if (dist < minDist) continue;
+
+        const ContourPoint& a = pts[(i - k + n) % n];
+        const ContourPoint& b = pts[(i + k) % n];
+        float ax = static_cast<float>(a.x - p.x), ay = static_cast<float>(a.y - p.y);
+        float bx = static_cast<float>(b.x - p.x), by = static_cast<float>(b.y - p.y);
+        float la = std::sqrt(ax * ax + ay * ay), lb = std::sqrt(bx * bx + by * by);
+        if (la <= 0.0f || lb <= 0.0f) continue;
+        if ((ax * bx + ay * by) / (la * lb) < cosLimit) continue;   // angle too wide
+        scratch.push_back({dist, i});
+    }
+
+    std::sort(scratch.begin(), scratch.end(),
+              [](const std::pair<float, int>& a, const std::pair<float, int>& b) { return a.first > b.first; });
+    float merge2 = mergeDist * mergeDist;
+    for (const auto& c : scratch) {
+        const ContourPoint& p = pts[c.second];
+        bool nearKept = false;
+        for (int j : out) {
+            float dx = static_cast<float>(pts[j].x - p.x), dy = static_cast<float>(pts[j].y - p.y);
+            if (dx * dx + dy * dy < merge2) { nearKept = true; break; }
+        }
+        if (nearKept) continue;
+        out.push_back(c.second);
+        if (static_cast<int>(out.size()) >= maxTips) break;
+    }
+}
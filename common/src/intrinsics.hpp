@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+// Pinhole intrinsics of the depth image, in pixels of the depth frame.
+// Source priority: configured in the web UI > reported by the device SDK >
+// estimated from the sensor's nominal horizontal field of view.
+struct CameraIntrinsics {
+    int width = 0;
+    int height = 0;
+    float fx = 0.0f, fy = 0.0f;     // focal length (px)
+    float cx = 0.0f, cy = 0.0f;     // principal point (px)
+
+    bool valid() const { return fx > 0.0f && fy > 0.0f && width > 0 && height > 0; }
+};
+
+// Square-pixel estimate from a horizontal field of view, principal point at center.
+inline CameraIntrinsics estimateIntrinsics(int width, int height, float hfovDeg) {
+    CameraIntrinsics k;
+    k.width = width;
+    k.height = height;
+    k.fx = k.fy = (width * 0.5f) / std::tan(hfovDeg * 0.5f * 3.14159265f / 180.0f);
+    k.cx = (width - 1) * 0.5f;
+    k.cy = (height - 1) * 0.5f;
+    return k;
+}
+
+// Rescale intrinsics calibrated at one resolution to another (same aspect / crop).
+inline CameraIntrinsics scaleIntrinsics(const CameraIntrinsics& k, int width, int height) {
+    if (!k.valid() || (k.width == width && k.height == height)) return k;
+    CameraIntrinsics s = k;
+    float sx = static_cast<float>(width) / k.width;
+    float sy = static_cast<float>(height) / k.height;
+    s.width = width;
+    s.height = height;
+    s.fx *= sx;
+    s.fy *= sy;
+    s.cx *= sx;
+    s.cy *= sy;
+    return s;
+}
+
+// Parse "fx,fy,cx,cy" (pixels at the current depth resolution).
+inline bool parseIntrinsics(const std::string& text, int width, int height, CameraIntrinsics& out) {
+    float v[4];
+    const char* p = text.c_str();
+    for (int i = 0; i < 4; i++) {
+        char* end = nullptr;
+        v[i] = std::strtof(p, &end);
+        if (end == p) return false;
+        p = end;
+        while (*p == ' ' || *p == ',') p++;
+    }
+    if (v[0] <= 0.0f || v[1] <= 0.0f) return false;
+    out.width = width;
+    out.height = height;
+    out.fx = v[0];
+    out.fy = v[1];
+    out.cx = v[2];
+    out.cy = v[3];
+    return true;
+}
+
+// Pick the intrinsics to use for a depth frame of the given size.
+inline CameraIntrinsics resolveIntrinsics(const std::string& configured,
+                                          const CameraIntrinsics& device,
+                                          int width, int height, float hfovDeg) {
+    CameraIntrinsics k;
+    if (!configured.empty() && parseIntrinsics(configured, width, height, k)) return k;
+    if (device.valid()) return scaleIntrinsics(device, width, height);
+    return estimateIntrinsics(width, height, hfovDeg);
+}
+
+inline std::string intrinsicsJson(const CameraIntrinsics& k) {
+    char buf[160];
+    std::snprintf(buf, sizeof(buf),
+                  "{\"w\":%d,\"h\":%d,\"fx\":%.2f,\"fy\":%.2f,\"cx\":%.2f,\"cy\":%.2f}",
+                  k.width, k.height, k.fx, k.fy, k.cx, k.cy);
+    return buf;
+}
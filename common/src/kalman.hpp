@@ -0,0 +1,70 @@
+#pragma once
+
+// Constant-velocity Kalman filter for one tracked blob in image space
+// (px, px/s). x and y follow the same model with the same noise and are always
+// updated together, so they share one 2x2 covariance (pp, pv, vv) and the
+// whole state is a handful of floats. Acceleration is not part of the state;
+// it is the low-passed change of the filtered velocity, for consumers that
+// want it.
+struct BlobKalman {
+    float pos[2] = {0.0f, 0.0f};
+    float vel[2] = {0.0f, 0.0f};
+    float acc[2] = {0.0f, 0.0f};
+    float pp = 0.0f, pv = 0.0f, vv = 0.0f;   // covariance (per axis)
+
+    // Tunables: centroid measurement noise and the white acceleration that
+    // models hands starting, stopping and turning.
+    static constexpr float kMeasureVar = 1.5f * 1.5f;        // px^2
+    static constexpr float kAccelSigma = 3000.0f;            // px/s^2
+    static constexpr float kInitVelVar = 1000.0f * 1000.0f;  // (px/s)^2, unknown at birth
+    static constexpr float kAccSmoothing = 0.3f;
+
+    void init(float x, float y) {
+        pos[0] = x;
+        pos[1] = y;
+        vel[0] = vel[1] = 0.0f;
+        acc[0] = acc[1] = 0.0f;
+        pp = kMeasureVar;
+        pv = 0.0f;
+        vv = kInitVelVar;
+    }
+
+    // Advance the state by dt seconds.
+    void predict(float dt) {
+        pos[0] += vel[0] * dt;
+        pos[1] += vel[1] * dt;
+        float q = kAccelSigma * kAccelSigma;
+        float dt2 = dt * dt;
+        float npp = pp + 2.0f * dt * pv + dt2 * vv + q * dt2 * dt2 * 0.25f;
+        float npv = pv + dt * vv + q * dt2 * dt * 0.5f;
+        float nvv = vv + q * dt2;
+        pp = npp;
+        pv = npv;
+        vv = nvv;
+    }
+
+    // Innovation variance per axis: the predicted position's uncertainty
+    // plus the measurement noise.
+    float innovationVar() const { return pp + kMeasureVar; }
+
+    // Fold in a measured centroid; dt is the step of the preceding predict().
+    void correct(float x, float y, float dt) {
+        float s = innovationVar();
+        float kp = pp / s, kv = pv / s;
+        float prevVel[2] = {vel[0], vel[1]};
+        float m[2] = {x, y};
+        for (int i = 0; i < 2; i++) {
+            float r = m[i] - pos[i];
+            pos[i] += kp * r;
+            vel[i] += kv * r;
+            if (dt > 0.0f)
+                acc[i] += kAccSmoothing * ((vel[i] - prevVel[i]) / dt - acc[i]);
+        }
+        float npp = (1.0f - kp) * pp;
+        float npv = (1.0f - kp) * pv;
+        float nvv = vv - kv * pv;
+        pp = npp;
+        pv = npv;
+        vv = nvv;
+    }
+};
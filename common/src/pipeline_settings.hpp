@@ -0,0 +1,76 @@
+#pragma once
+
+#include <string>
+
+// Software processing settings shared by both platforms and edited from the
+// web UI. Unlike the per-frame atomics (threshold, blob sizes), these are
+// compound values: the WebServer keeps them under a mutex and bumps a sequence
+// number on every change so the frame loop only re-reads (and recompiles any
+// derived tables) when something actually changed.
+struct PipelineSettings {
+    // Region of interest (see roimask.hpp for the spec format)
+    bool roiEnabled = false;
+    std::string roiCrop;        // "x0,y0,x1,y1" normalized, empty = full frame
+    std::string roiExclude;     // exclusion polygons, normalized
+
+    // Hysteresis: weak band beyond the threshold that only grows existing blobs
+    int hysteresisMm = 0;       // 0 = single threshold
+
+    // Surface plane: segment by height above a fitted table/floor (see plane.hpp)
+    bool planeEnabled = false;
+    int planeMinMm = 15;        // ignore everything closer to the surface than this
+    int planeMaxMm = 200;       // and everything higher above it than this
+    std::string intrinsics;     // "fx,fy,cx,cy" override, empty = device / estimate
+
+    // Depth bands: independent blob layers per band (see bands.hpp)
+    bool bandsEnabled = false;
+    std::string bands;          // "near-far, near-far, ..."
+
+    // Oversized blobs are split along depth steps above this (see splitBlobByDepth)
+    int splitStepMm = 0;        // 0 = drop oversized blobs
+
+    // Keep at most this many blobs per frame (0 = all), largest or nearest first
+    int maxBlobs = 0;
+    bool nearestFirst = false;
+
+    // Track with the globally optimal assignment instead of greedy (see assignment.hpp)
+    bool optimalAssignment = false;
+
+    // Track lifecycle: frames a new blob must be seen before it is published,
+    // and frames a lost track coasts on its prediction before it ends
+    int confirmFrames = 2;
+    int coastFrames = 3;
+
+    // Minimum match radius in mm at each blob's depth; 0 = fixed pixel radius
+    int matchGateMm = 0;
+
+    // Publish blobs only when a track starts, ends or moves (or its tips or
+    // the zone occupancy change) more than the epsilons, plus a full frame
+    // every keyframeMs; frames that go out still list every blob (see blobpublish.hpp)
+    bool deltaPublish = false;
+    int deltaPx = 2;
+    int deltaMm = 10;
+    int keyframeMs = 1000;
+
+    // Gestures recognized over the tracks (see gestures.hpp)
+    bool gesturesEnabled = false;
+    int tapMaxMs = 250;         // tap: shortest-lived still blob
+    int holdMs = 600;           // hold: still this long
+    int stillRadiusPx = 15;     // "still" for tap and hold
+    int swipeSpeed = 600;       // px/s
+    int swipeMinPx = 60;        // travel of a swipe
+    int pinchStepPct = 10;      // distance change between pinch events
+
+    // Re-label only the mask tiles that changed since the last frame (see tilelabel.hpp)
+    bool incrementalLabeling = false;
+
+    // Blob outlines traced from the label image (see contour.hpp)
+    bool contoursEnabled = false;
+    int contourEpsilonPx = 2;   // Douglas-Peucker tolerance
+    int contourMaxVertices = 64;   // vertices per outline, 0 = no limit
+    int maxTips = 0;            // extremities (fingertips) per blob, 0 = off (see hull.hpp)
+
+    // Multi-zone segmentation (see zones.hpp for the spec format)
+    bool zonesEnabled = false;
+    std::string zones;          // "near-far: x,y x,y x,y; ..."
+};
@@ -0,0 +1,360 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <future>
+#include <string>
+#include <vector>
+
+#include "depthcolor.hpp"
+#include "intrinsics.hpp"
+#include "roimask.hpp"
+
+// Table / floor plane estimation for tilted touch-surface setups.
+//
+// A sparse grid of depth samples is back-projected with the camera intrinsics
+// and a plane is fitted with RANSAC (then least-squares refined on the
+// inliers). From the plane we precompute, per pixel, the depth band that lies
+// between minHeight and maxHeight above the surface, so per-frame segmentation
+// is a plain compare against two uint16 tables. Fitting runs on a background
+// thread; the frame loop keeps using the previous tables until it finishes.
+
+struct PlanePoint {
+    float x, y, z;      // camera space, mm
+};
+
+struct PlaneModel {
+    // n.P + d = 0 with |n| = 1 and n pointing towards the camera, so d is the
+    // camera's distance to the plane and height() is positive above the surface.
+    float nx = 0.0f, ny = 0.0f, nz = -1.0f;
+    float d = 0.0f;
+    int inliers = 0;
+    int samples = 0;
+    bool valid = false;
+
+    float height(const PlanePoint& p) const { return nx * p.x + ny * p.y + nz * p.z + d; }
+};
+
+// Back-project every stride-th pixel with valid depth into camera space.
+inline void samplePlanePoints(const uint16_t* depthMm, const CameraIntrinsics& k, int stride,
+                              std::vector<PlanePoint>& out) {
+    out.clear();
+    for (int y = stride / 2; y < k.height; y += stride) {
+        for (int x = stride / 2; x < k.width; x += stride) {
+            uint16_t d = depthMm[y * k.width + x];
+            if (d == 0) continue;
+            float z = static_cast<float>(d);
+            out.push_back({(x - k.cx) * z / k.fx, (y - k.cy) * z / k.fy, z});
+        }
+    }
+}
+
+// Least-squares refit of z = a*x + b*y + c over the inliers of a plane.
+// Returns false if the system is degenerate (plane parallel to the optical axis).
+inline bool refinePlane(const std::vector<PlanePoint>& pts, float inlierMm, PlaneModel& p) {
+    double sxx = 0, sxy = 0, sx = 0, syy = 0, sy = 0, n = 0, sxz = 0, syz = 0, sz = 0;
+    for (const auto& q : pts) {
+        if (std::fabs(p.height(q)) > inlierMm) continue;
+        sxx += q.x * q.x; sxy += q.x * q.y; sx += q.x;
+        syy += q.y * q.y; sy += q.y; n += 1;
+        sxz += q.x * q.z; syz += q.y * q.z; sz += q.z;
+    }
+    if (n < 3) return false;
+    // | sxx sxy sx | |a|   |sxz|
+    // | sxy syy sy | |b| = |syz|
+    // | sx  sy  n  | |c|   |sz |
+    double det = sxx * (syy * n - sy * sy) - sxy * (sxy * n - sy * sx) + sx * (sxy * sy - syy * sx);
+    if (std::fabs(det) < 1e-9) return false;
+    double a = (sxz * (syy * n - sy * sy) - sxy * (syz * n - sy * sz) + sx * (syz * sy - syy * sz)) / det;
+    double b = (sxx * (syz * n - sz * sy) - sxz * (sxy * n - sy * sx) + sx * (sxy * sz - syz * sx)) / det;
+    double c = (sxx * (syy * sz - sy * syz) - sxy * (sxy * sz - sy * sxz) + sx * (sxy * syz - syy * sxz)) / det;
+    if (c <= 0) return false;   // plane must lie in front of the camera
+
+    // a*x + b*y - z + c = 0, scaled to a unit normal
+    double s = std::sqrt(a * a + b * b + 1.0);
+    p.nx = static_cast<float>(a / s);
+    p.ny = static_cast<float>(b / s);
+    p.nz = static_cast<float>(-1.0 / s);
+    p.d = static_cast<float>(c / s);
+    return true;
+}
+
+// RANSAC plane fit over camera-space samples. Deterministic for a given seed.
+inline PlaneModel fitPlaneRansac(const std::vector<PlanePoint>& pts, float inlierMm,
+                                 int iterations, uint32_t seed = 0x9e3779b9u) {
+    PlaneModel best;
+    int n = static_cast<int>(pts.size());
+    best.samples = n;
+    if (n < 3) return best;
+
+    uint32_t rng = seed ? seed : 1u;
+    auto next = [&]() {
+        rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+        return static_cast<int>(rng % static_cast<uint32_t>(n));
+    };
+    auto countInliers = [&](const PlaneModel& m) {
+        int c = 0;
+        for (const auto& q : pts)
+            if (std::fabs(m.height(q)) <= inlierMm) c++;
+        return c;
+    };
+
+    for (int it = 0; it < iterations; it++) {
+        int i0 = next(), i1 = next(), i2 = next();
+        if (i0 == i1 || i1 == i2 || i0 == i2) continue;
+        const PlanePoint& a = pts[i0];
+        const PlanePoint& b = pts[i1];
+        const PlanePoint& c = pts[i2];
+        float ux = b.x - a.x, uy = b.y - a.y, uz = b.z - a.z;
+        float vx = c.x - a.x, vy = c.y - a.y, vz = c.z - a.z;
+        PlaneModel m;
+        m.nx = uy * vz - uz * vy;
+        m.ny = uz * vx - ux * vz;
+        m.nz = ux * vy - uy * vx;
+        float len = std::sqrt(m.nx * m.nx + m.ny * m.ny + m.nz * m.nz);
+        if (len < 1e-3f) continue;  // collinear sample
+        m.nx /= len; m.ny /= len; m.nz /= len;
+        m.d = -(m.nx * a.x + m.ny * a.y + m.nz * a.z);
+        if (m.d < 0) { m.nx = -m.nx; m.ny = -m.ny; m.nz = -m.nz; m.d = -m.d; }
+        m.inliers = countInliers(m);
+        if (m.inliers > best.inliers) best = m;
+    }
+    if (best.inliers < 3) return PlaneModel{};
+
+    PlaneModel refined = best;
+    if (refinePlane(pts, inlierMm, refined)) {
+        refined.inliers = countInliers(refined);
+        if (refined.inliers >= best.inliers) best = refined;
+    }
+    best.samples = n;
+    best.valid = true;
+    return best;
+}
+
+// Depth (mm) at which each pixel's ray meets the plane; 0 where the ray never
+// reaches the plane in front of the camera (e.g. above the horizon).
+inline void buildExpectedDepth(const PlaneModel& p, const CameraIntrinsics& k,
+                               std::vector<float>& out) {
+    out.assign(static_cast<size_t>(k.width) * k.height, 0.0f);
+    for (int y = 0; y < k.height; y++) {
+        float ry = (y - k.cy) / k.fy;
+        for (int x = 0; x < k.width; x++) {
+            float rx = (x - k.cx) / k.fx;
+            float dot = p.nx * rx + p.ny * ry + p.nz;
+            if (dot >= -1e-6f) continue;
+            out[y * k.width + x] = std::min(65535.0f, -p.d / dot);
+        }
+    }
+}
+
+// Threshold depth by height above the fitted plane: a pixel is foreground when
+// nearLimit[i] <= depth < farLimit[i] (see PlaneEstimator). hysteresisMm adds a
+// weak band beyond farLimit, as in depthToThresholdBgr; not where the ray misses
+// the plane (both limits 0), which is never foreground.
+inline void depthToPlaneThresholdBgr(const uint16_t* depthMm, int width, int height,
+                                     uint8_t* outBgr, const uint16_t* nearLimit,
+                                     const uint16_t* farLimit, const RoiSpans* roi = nullptr,
+                                     uint16_t hysteresisMm = 0) {
+    auto thresholdPixel = [&](int i) {
+        int d = depthMm[i];
+        uint8_t v = 255;
+        if (d > 0 && d >= nearLimit[i]) {
+            if (d < farLimit[i]) v = 0;
+            else if (farLimit[i] > 0 && d < farLimit[i] + hysteresisMm) v = kWeakForeground;
+        }
+        outBgr[i * 3 + 0] = v;
+        outBgr[i * 3 + 1] = v;
+        outBgr[i * 3 + 2] = v;
+    };
+
+    if (!roi || roi->full) {
+        int total = width * height;
+        for (int i = 0; i < total; i++) thresholdPixel(i);
+        return;
+    }
+
+    std::memset(outBgr, 255, static_cast<size_t>(width) * height * 3);
+    for (int y = 0; y < height; y++) {
+        for (int s = roi->rowBegin(y); s < roi->rowEnd(y); s++) {
+            const Span& sp = roi->spans[s];
+            for (int i = y * width + sp.x0; i < y * width + sp.x1; i++) thresholdPixel(i);
+        }
+    }
+}
+
+// Owns the fitted plane and its per-pixel limit tables for one depth stream.
+// Call update() once per depth frame from the frame thread; fits run on a
+// background task and are adopted on a later update().
+class PlaneEstimator {
+public:
+    ~PlaneEstimator() {
+        if (pending_.valid()) pending_.wait();
+    }
+
+    // Set intrinsics and the height band above the surface (mm).
+    // A change of intrinsics invalidates the plane and schedules a refit.
+    void configure(const CameraIntrinsics& k, int minHeightMm, int maxHeightMm) {
+        bool intrChanged = k.width != intr_.width || k.height != intr_.height ||
+                           k.fx != intr_.fx || k.fy != intr_.fy ||
+                           k.cx != intr_.cx || k.cy != intr_.cy;
+        bool bandChanged = minHeightMm != minHeightMm_ || maxHeightMm != maxHeightMm_;
+        intr_ = k;
+        minHeightMm_ = minHeightMm;
+        maxHeightMm_ = maxHeightMm;
+        if (intrChanged) {
+            plane_ = PlaneModel{};
+            expected_.clear();
+            refitRequested_ = true;
+        } else if (bandChanged && plane_.valid) {
+            buildLimits();
+        }
+    }
+
+    void requestRefit() { refitRequested_ = true; }
+
+    // Adopt a finished fit, watch for camera bumps and launch fits as needed.
+    // Returns true when the plane changed (status worth republishing).
+    bool update(const uint16_t* depthMm) {
+        bool changed = false;
+        if (pending_.valid() &&
+            pending_.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+            FitResult r = pending_.get();
+            if (r.plane.valid && sameIntrinsics(r.intr)) {
+                plane_ = r.plane;
+                expected_ = std::move(r.expected);
+                buildLimits();
+                fits_++;
+            }
+            changed = true;
+        }
+
+        frame_++;
+        if (!pending_.valid() && intr_.valid()) {
+            bool periodic = (frame_ % kCheckInterval) == 0;
+            if (!plane_.valid && periodic) refitRequested_ = true;   // retry failed fits
+            if (plane_.valid && periodic && !refitRequested_ && surfaceMoved(depthMm)) {
+                bumps_++;
+                refitRequested_ = true;
+            }
+            if (refitRequested_) {
+                launchFit(depthMm);
+                changed = true;
+            }
+        }
+        return changed;
+    }
+
+    bool active() const { return plane_.valid; }
+    const PlaneModel& plane() const { return plane_; }
+    const uint16_t* nearLimit() const { return nearLimit_.data(); }
+    const uint16_t* farLimit() const { return farLimit_.data(); }
+
+    // Status for GET /plane
+    std::string json() const {
+        float tilt = std::acos(std::min(1.0f, std::fabs(plane_.nz))) * 180.0f / 3.14159265f;
+        char buf[256];
+        std::snprintf(buf, sizeof(buf),
+                      "{\"valid\":%s,\"normal\":[%.4f,%.4f,%.4f],\"d\":%.1f,\"tiltDeg\":%.1f,"
+                      "\"inliers\":%d,\"samples\":%d,\"fits\":%d,\"bumps\":%d,\"fitting\":%s,"
+                      "\"intrinsics\":",
+                      plane_.valid ? "true" : "false", plane_.nx, plane_.ny, plane_.nz, plane_.d,
+                      tilt, plane_.inliers, plane_.samples, fits_, bumps_,
+                      pending_.valid() ? "true" : "false");
+        return std::string(buf) + intrinsicsJson(intr_) + "}";
+    }
+
+private:
+    static constexpr int kCheckInterval = 15;     // frames between bump checks
+    static constexpr int kTargetSamples = 3000;   // sparse grid size for fitting
+    static constexpr int kIterations = 200;
+    static constexpr float kInlierMm = 12.0f;
+
+    struct FitResult {
+        PlaneModel plane;
+        CameraIntrinsics intr;
+        std::vector<float> expected;
+    };
+
+    int sampleStride() const {
+        int s = static_cast<int>(std::sqrt(static_cast<float>(intr_.width) * intr_.height / kTargetSamples));
+        return std::max(2, s);
+    }
+
+    bool sameIntrinsics(const CameraIntrinsics& k) const {
+        return k.width == intr_.width && k.height == intr_.height && k.fx == intr_.fx &&
+               k.fy == intr_.fy && k.cx == intr_.cx && k.cy == intr_.cy;
+    }
+
+    void launchFit(const uint16_t* depthMm) {
+        refitRequested_ = false;
+        std::vector<PlanePoint> pts;
+        samplePlanePoints(depthMm, intr_, sampleStride(), pts);
+        CameraIntrinsics k = intr_;
+        uint32_t seed = 0x9e3779b9u + static_cast<uint32_t>(fits_ + bumps_);
+        pending_ = std::async(std::launch::async, [pts = std::move(pts), k, seed]() {
+            FitResult r;
+            r.intr = k;
+            r.plane = fitPlaneRansac(pts, kInlierMm, kIterations, seed);
+            if (r.plane.valid) buildExpectedDepth(r.plane, k, r.expected);
+            return r;
+        });
+    }
+
+    // Compare the sparse grid against the expected surface. The camera moved if
+    // many samples now lie behind the surface, or far fewer lie on it than at fit time.
+    bool surfaceMoved(const uint16_t* depthMm) const {
+        int stride = sampleStride();
+        int valid = 0, on = 0, behind = 0;
+        float tol = kInlierMm * 2.0f;
+        for (int y = stride / 2; y < intr_.height; y += stride) {
+            for (int x = stride / 2; x < intr_.width; x += stride) {
+                int i = y * intr_.width + x;
+                float e = expected_[i];
+                uint16_t d = depthMm[i];
+                if (d == 0 || e <= 0.0f) continue;
+                valid++;
+                if (std::fabs(d - e) <= tol) on++;
+                else if (d > e + tol) behind++;
+            }
+        }
+        if (valid < 50 || plane_.samples == 0) return false;
+        float fitRatio = static_cast<float>(plane_.inliers) / plane_.samples;
+        return behind * 5 > valid || on < valid * fitRatio * 0.5f;
+    }
+
+    // nearLimit/farLimit: depth band between maxHeight and minHeight above the
+    // surface. For a pixel whose ray meets the plane at depth E, a point at depth
+    // z lies h = d * (1 - z / E) above the plane, so h in [minH, maxH) maps to
+    // z in (E * (1 - maxH/d), E * (1 - minH/d)].
+    void buildLimits() {
+        size_t n = expected_.size();
+        nearLimit_.assign(n, 0);
+        farLimit_.assign(n, 0);
+        if (!plane_.valid || plane_.d <= 0.0f) return;
+        float kNear = std::max(0.0f, 1.0f - maxHeightMm_ / plane_.d);
+        float kFar = std::max(0.0f, 1.0f - minHeightMm_ / plane_.d);
+        for (size_t i = 0; i < n; i++) {
+            float e = expected_[i];
+            if (e <= 0.0f) continue;   // no surface on this ray: never foreground
+            nearLimit_[i] = static_cast<uint16_t>(std::max(1.0f, e * kNear));
+            farLimit_[i] = static_cast<uint16_t>(std::min(65535.0f, e * kFar));
+        }
+    }
+
+    CameraIntrinsics intr_;
+    int minHeightMm_ = 0;
+    int maxHeightMm_ = 0;
+    PlaneModel plane_;
+    std::vector<float> expected_;
+    std::vector<uint16_t> nearLimit_;
+    std::vector<uint16_t> farLimit_;
+    std::future<FitResult> pending_;
+    bool refitRequested_ = true;
+    int frame_ = 0;
+    int fits_ = 0;
+    int bumps_ = 0;
+};
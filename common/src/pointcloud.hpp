@@ -0,0 +1,119 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "deproject.hpp"
+
+// Point cloud from a depth frame, deprojected through the DepthRays tables
+// (camera space, mm: x right, y down, z forward). Served on /pointcloud.
+//
+// Packed format (little-endian):
+//   header  16 bytes: "DPC1", u32 seq, u32 point count, u8 flags
+//                     (bit 0: color), u8 stride, u16 reserved
+//   point   12 bytes: f32 x, f32 y, f32 z, plus with color 4 bytes: u8 r, g, b, pad
+// PLY: binary_little_endian 1.0, float x/y/z (+ uchar red/green/blue).
+
+struct PointCloudOptions {
+    int stride = 1;                 // take every stride-th pixel in x and y
+    bool foregroundOnly = false;    // only pixels set in the foreground mask
+    bool color = false;             // attach the color pixel (needs a color frame)
+    bool ply = false;               // binary PLY instead of the packed format
+    bool crop = false;              // only [x0, x1) x [y0, y1) (depth pixels), else the full frame
+    int x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+};
+
+constexpr size_t kPointCloudHeaderSize = 16;
+
+// Color of a depth pixel: bgr is either the registered color-in-depth image
+// (same size as depth, see registration.hpp) or, without registration, the
+// raw color frame sampled at the same normalized position.
+struct PointCloudColor {
+    const uint8_t* bgr = nullptr;
+    int width = 0, height = 0;
+    int depthW = 1, depthH = 1;
+
+    void at(int x, int y, uint8_t rgb[3]) const {
+        int cx = x * width / depthW;
+        int cy = y * height / depthH;
+        const uint8_t* p = bgr + (static_cast<size_t>(cy) * width + cx) * 3;
+        rgb[0] = p[2];
+        rgb[1] = p[1];
+        rgb[2] = p[0];
+    }
+};
+
+// Build one point cloud into out (resized, so a reused string keeps its
+// capacity across frames). fgMask has one byte per depth pixel, non-zero =
+// foreground; it is only read with foregroundOnly. Returns the point count.
+inline size_t buildPointCloud(const uint16_t* depthMm, const uint8_t* fgMask, int width, int height,
+                              const DepthRays& rays, const PointCloudOptions& opt,
+                              const PointCloudColor& color, uint32_t seq, std::string& out) {
+    int stride = opt.stride < 1 ? 1 : opt.stride;
+    int x0 = 0, y0 = 0, x1 = width, y1 = height;
+    if (opt.crop) {
+        // Corners in either order, clamped to the frame; an empty crop has no points
+        x0 = std::max(0, std::min(opt.x0, opt.x1));
+        x1 = std::min(width, std::max(opt.x0, opt.x1));
+        y0 = std::max(0, std::min(opt.y0, opt.y1));
+        y1 = std::min(height, std::max(opt.y0, opt.y1));
+    }
+    bool fg = opt.foregroundOnly && fgMask;
+    bool withColor = opt.color && color.bgr && color.width > 0 && color.height > 0;
+
+    auto keep = [&](int i) { return depthMm[i] != 0 && (!fg || fgMask[i]); };
+
+    // Count first: both formats carry the point count before the points
+    size_t count = 0;
+    if (rays.valid()) {
+        for (int y = y0; y < y1; y += stride)
+            for (int x = x0; x < x1; x += stride)
+                if (keep(y * width + x)) count++;
+    }
+
+    std::string header;
+    size_t pointSize = 12 + (withColor ? (opt.ply ? 3 : 4) : 0);
+    if (opt.ply) {
+        header = "ply\nformat binary_little_endian 1.0\ncomment seq " + std::to_string(seq) +
+                 "\nelement vertex " + std::to_string(count) +
+                 "\nproperty float x\nproperty float y\nproperty float z\n";
+        if (withColor) header += "property uchar red\nproperty uchar green\nproperty uchar blue\n";
+        header += "end_header\n";
+    } else {
+        header.assign(kPointCloudHeaderSize, '\0');
+        std::memcpy(&header[0], "DPC1", 4);
+        for (int b = 0; b < 4; b++) {
+            header[4 + b] = static_cast<char>((seq >> (8 * b)) & 0xFF);
+            header[8 + b] = static_cast<char>((count >> (8 * b)) & 0xFF);
+        }
+        header[12] = static_cast<char>(withColor ? 1 : 0);
+        header[13] = static_cast<char>(stride > 255 ? 255 : stride);
+    }
+
+    out.resize(header.size() + count * pointSize);
+    std::memcpy(&out[0], header.data(), header.size());
+    if (count == 0) return 0;
+
+    char* dst = &out[header.size()];
+    for (int y = y0; y < y1; y += stride) {
+        for (int x = x0; x < x1; x += stride) {
+            int i = y * width + x;
+            if (!keep(i)) continue;
+            float xyz[3];
+            xyz[2] = depthMm[i];
+            rays.pixel(x, y, xyz[2], xyz[0], xyz[1]);
+            std::memcpy(dst, xyz, 12);   // f32 in host order (little-endian targets)
+            dst += 12;
+            if (withColor) {
+                uint8_t rgb[3];
+                color.at(x, y, rgb);
+                std::memcpy(dst, rgb, 3);
+                if (!opt.ply) dst[3] = 0;
+                dst += opt.ply ? 3 : 4;
+            }
+        }
+    }
+    return count;
+}
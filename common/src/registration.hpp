@@ -0,0 +1,332 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "blobdetect.hpp"
+#include "intrinsics.hpp"
+
+// Depth-to-color registration: maps every depth pixel into the color image
+// through the depth intrinsics, the depth->color rigid transform and the
+// color intrinsics. The depth-independent part (the rotated ray of each depth
+// pixel) is precomputed once per configuration, so a frame costs a few
+// multiplies and one divide per pixel. A Z-buffer over the color image (cells
+// of about one depth pixel) keeps background that the color camera can't see
+// (behind a hand, from its viewpoint) from taking the color of what is in
+// front of it. Run on every
+// depth frame in color mode: the side-by-side view, the blob colors and
+// /pointcloud all use the registered image.
+
+// Rigid transform from depth camera space to color camera space (mm).
+struct CameraExtrinsics {
+    float r[9] = {1, 0, 0, 0, 1, 0, 0, 0, 1};   // row-major rotation
+    float t[3] = {0, 0, 0};                      // translation (mm)
+};
+
+// Registration file (whitespace or comma separated, '#' comments), e.g. from an
+// offline stereo calibration:
+//   color 1280 720 fx fy cx cy
+//   rotation r00 r01 r02 r10 r11 r12 r20 r21 r22
+//   translation tx ty tz          (mm, depth -> color)
+// Returns false if the file is missing or has no valid color intrinsics.
+inline bool loadRegistrationFile(const std::string& path, CameraIntrinsics& color,
+                                 CameraExtrinsics& ext) {
+    std::ifstream in(path);
+    if (!in) return false;
+    CameraIntrinsics k;
+    CameraExtrinsics e;
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t hash = line.find('#');
+        if (hash != std::string::npos) line.erase(hash);
+        for (char& c : line) if (c == ',') c = ' ';
+        std::istringstream ss(line);
+        std::string key;
+        if (!(ss >> key)) continue;
+        if (key == "color") {
+            ss >> k.width >> k.height >> k.fx >> k.fy >> k.cx >> k.cy;
+        } else if (key == "rotation") {
+            for (float& v : e.r) ss >> v;
+        } else if (key == "translation") {
+            for (float& v : e.t) ss >> v;
+        }
+    }
+    if (!k.valid()) return false;
+    color = k;
+    ext = e;
+    return true;
+}
+
+// A few persistent worker threads that split a row range into contiguous
+// bands; the calling thread takes the first band. Threads are started once,
+// not per call.
+class RowWorkers {
+public:
+    ~RowWorkers() { stop(); }
+
+    void start(int threads) {
+        if (!workers_.empty() || threads <= 1) return;
+        count_ = threads;
+        for (int i = 1; i < threads; i++) workers_.emplace_back(&RowWorkers::loop, this, i);
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            quit_ = true;
+        }
+        wake_.notify_all();
+        for (auto& t : workers_) t.join();
+        workers_.clear();
+        quit_ = false;
+        count_ = 1;
+    }
+
+    // Run fn(y0, y1) over [0, rows); returns when every band is done.
+    template <typename Fn>
+    void run(int rows, Fn&& fn) {
+        if (workers_.empty() || rows < count_ * 8) {
+            fn(0, rows);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            using F = typename std::remove_reference<Fn>::type;
+            call_ = [](void* ctx, int y0, int y1) { (*static_cast<F*>(ctx))(y0, y1); };
+            ctx_ = &fn;
+            rows_ = rows;
+            pending_ = count_ - 1;
+            generation_++;
+        }
+        wake_.notify_all();
+        fn(0, rows / count_);
+        std::unique_lock<std::mutex> lock(mtx_);
+        done_.wait(lock, [&] { return pending_ == 0; });
+    }
+
+private:
+    void loop(int band) {
+        unsigned seen = 0;
+        for (;;) {
+            void (*call)(void*, int, int);
+            void* ctx;
+            int rows;
+            {
+                std::unique_lock<std::mutex> lock(mtx_);
+                wake_.wait(lock, [&] { return quit_ || generation_ != seen; });
+                if (quit_) return;
+                seen = generation_;
+                call = call_;
+                ctx = ctx_;
+                rows = rows_;
+            }
+            call(ctx, rows * band / count_, rows * (band + 1) / count_);
+            {
+                std::lock_guard<std::mutex> lock(mtx_);
+                pending_--;
+            }
+            done_.notify_one();
+        }
+    }
+
+    std::vector<std::thread> workers_;
+    int count_ = 1;
+    std::mutex mtx_;
+    std::condition_variable wake_, done_;
+    void (*call_)(void*, int, int) = nullptr;
+    void* ctx_ = nullptr;
+    int rows_ = 0;
+    int pending_ = 0;
+    unsigned generation_ = 0;
+    bool quit_ = false;
+};
+
+class DepthColorRegistration {
+public:
+    // Rebuilds the tables only when something changed.
+    void configure(const CameraIntrinsics& depth, const CameraIntrinsics& color,
+                   const CameraExtrinsics& ext) {
+        if (same(depth, depth_) && same(color, color_) && sameExt(ext)) return;
+        depth_ = depth;
+        color_ = color;
+        ext_ = ext;
+        dirX_.clear();
+        dirY_.clear();
+        dirZ_.clear();
+        if (!depth.valid() || !color.valid()) return;
+
+        // Rotated ray of every depth pixel: P_color = z * dir + t
+        size_t n = static_cast<size_t>(depth.width) * depth.height;
+        dirX_.resize(n);
+        dirY_.resize(n);
+        dirZ_.resize(n);
+        const float* r = ext.r;
+        for (int y = 0; y < depth.height; y++) {
+            float ry = (y - depth.cy) / depth.fy;
+            for (int x = 0; x < depth.width; x++) {
+                float rx = (x - depth.cx) / depth.fx;
+                size_t i = static_cast<size_t>(y) * depth.width + x;
+                dirX_[i] = r[0] * rx + r[1] * ry + r[2];
+                dirY_[i] = r[3] * rx + r[4] * ry + r[5];
+                dirZ_[i] = r[6] * rx + r[7] * ry + r[8];
+            }
+        }
+
+        // Z-buffer cells of about one depth pixel's footprint in the color image,
+        // so every depth pixel writes and tests exactly one cell
+        float scale = color.fx / depth.fx;
+        int cell = scale > 1.0f ? static_cast<int>(std::ceil(scale)) : 1;
+        if (cell > 4) cell = 4;
+        zbufW_ = (color.width + cell - 1) / cell;
+        cellOfU_.resize(color.width);
+        cellOfV_.resize(color.height);
+        for (int u = 0; u < color.width; u++) cellOfU_[u] = u / cell;
+        for (int v = 0; v < color.height; v++) cellOfV_[v] = static_cast<uint32_t>(v / cell) * zbufW_;
+        zbuf_.resize(static_cast<size_t>(zbufW_) * ((color.height + cell - 1) / cell));
+        target_.resize(n);
+        zcell_.resize(n);
+        colorZ_.resize(n);
+        visible_.assign(n, 0);
+
+        int threads = static_cast<int>(std::thread::hardware_concurrency());
+        workers_.start(threads > kMaxThreads ? kMaxThreads : threads);
+    }
+
+    bool ready() const { return !dirX_.empty(); }
+    const CameraIntrinsics& colorIntrinsics() const { return color_; }
+
+    // Color-in-depth: the color seen by every depth pixel (BGR, depth
+    // resolution), black where depth is invalid, projects outside the color
+    // frame or is hidden from the color camera by something nearer.
+    // Three passes: project every pixel (rows in parallel), keep the nearest
+    // color-camera depth per Z-buffer cell (serial, keeps the Z-test
+    // race-free), then gather the color of the pixels that pass the Z-test
+    // (rows in parallel).
+    void colorInDepth(const uint16_t* depthMm, const uint8_t* colorBgr, uint8_t* outBgr) {
+        int w = depth_.width;
+        workers_.run(depth_.height, [&](int y0, int y1) {
+            for (size_t i = static_cast<size_t>(y0) * w; i < static_cast<size_t>(y1) * w; i++) {
+                int u, v;
+                float z;
+                if (!project(i, depthMm[i], u, v, z)) {
+                    target_[i] = kNoTarget;
+                    continue;
+                }
+                target_[i] = static_cast<uint32_t>(v) * color_.width + u;
+                zcell_[i] = cellOfV_[v] + cellOfU_[u];
+                colorZ_[i] = z < 65535.0f ? static_cast<uint16_t>(z) : uint16_t(65535);
+            }
+        });
+
+        std::fill(zbuf_.begin(), zbuf_.end(), uint16_t(65535));
+        size_t n = target_.size();
+        for (size_t i = 0; i < n; i++) {
+            if (target_[i] == kNoTarget) continue;
+            uint16_t& cell = zbuf_[zcell_[i]];
+            if (colorZ_[i] < cell) cell = colorZ_[i];
+        }
+
+        workers_.run(depth_.height, [&](int y0, int y1) {
+            for (size_t i = static_cast<size_t>(y0) * w; i < static_cast<size_t>(y1) * w; i++) {
+                uint8_t* o = outBgr + i * 3;
+                uint32_t t = target_[i];
+                bool visible = t != kNoTarget;
+                if (visible) {
+                    // Visible unless the nearest surface in this cell is clearly
+                    // in front (slack for the cell size and depth noise)
+                    uint16_t nearest = zbuf_[zcell_[i]];
+                    visible = colorZ_[i] <= nearest + kOcclusionSlackMm + (nearest >> 5);
+                }
+                visible_[i] = visible;
+                if (!visible) {
+                    o[0] = o[1] = o[2] = 0;
+                    continue;
+                }
+                const uint8_t* c = colorBgr + static_cast<size_t>(t) * 3;
+                o[0] = c[0];
+                o[1] = c[1];
+                o[2] = c[2];
+            }
+        });
+    }
+
+    // Mean registered color of every blob (hasColor false when none of its
+    // pixels is visible to the color camera), from the last colorInDepth
+    // output alignedBgr and the label image of the blobs.
+    void sampleBlobColors(std::vector<BlobInfo>& blobs, const std::vector<int>& labels,
+                          const uint8_t* alignedBgr) const {
+        int w = depth_.width;
+        for (auto& b : blobs) {
+            uint32_t sum[3] = {0, 0, 0};
+            uint32_t count = 0;
+            for (int y = b.minY; y <= b.maxY; y++) {
+                for (int x = b.minX; x <= b.maxX; x++) {
+                    size_t i = static_cast<size_t>(y) * w + x;
+                    if (labels[i] != b.label || !visible_[i]) continue;
+                    const uint8_t* c = alignedBgr + i * 3;
+                    sum[0] += c[0];
+                    sum[1] += c[1];
+                    sum[2] += c[2];
+                    count++;
+                }
+            }
+            b.hasColor = count > 0;
+            if (!count) continue;
+            b.colorB = static_cast<uint8_t>((sum[0] + count / 2) / count);
+            b.colorG = static_cast<uint8_t>((sum[1] + count / 2) / count);
+            b.colorR = static_cast<uint8_t>((sum[2] + count / 2) / count);
+        }
+    }
+
+private:
+    static constexpr int kMaxThreads = 4;
+    static constexpr uint32_t kNoTarget = 0xFFFFFFFFu;
+    static constexpr int kOcclusionSlackMm = 30;   // plus 1/32 of the depth
+
+    // Color pixel hit by depth pixel i at depth d, and its depth z in the color
+    // camera (mm); false if invalid or outside.
+    bool project(size_t i, uint16_t d, int& u, int& v, float& z) const {
+        if (!d) return false;
+        z = d * dirZ_[i] + ext_.t[2];
+        if (z <= 0.0f) return false;
+        float inv = 1.0f / z;
+        float fu = color_.fx * (d * dirX_[i] + ext_.t[0]) * inv + color_.cx + 0.5f;
+        float fv = color_.fy * (d * dirY_[i] + ext_.t[1]) * inv + color_.cy + 0.5f;
+        if (fu < 0.0f || fv < 0.0f) return false;
+        u = static_cast<int>(fu);
+        v = static_cast<int>(fv);
+        return u < color_.width && v < color_.height;
+    }
+
+    static bool same(const CameraIntrinsics& a, const CameraIntrinsics& b) {
+        return a.width == b.width && a.height == b.height && a.fx == b.fx && a.fy == b.fy &&
+               a.cx == b.cx && a.cy == b.cy;
+    }
+
+    bool sameExt(const CameraExtrinsics& e) const {
+        for (int k = 0; k < 9; k++) if (e.r[k] != ext_.r[k]) return false;
+        for (int k = 0; k < 3; k++) if (e.t[k] != ext_.t[k]) return false;
+        return true;
+    }
+
+    CameraIntrinsics depth_, color_;
+    CameraExtrinsics ext_;
+    std::vector<float> dirX_, dirY_, dirZ_;   // per depth pixel, structure of arrays
+    std::vector<uint32_t> target_;            // color index per depth pixel (kNoTarget: none)
+    std::vector<uint32_t> zcell_;             // Z-buffer cell per depth pixel
+    std::vector<uint16_t> colorZ_;            // depth in the color camera per depth pixel (mm)
+    std::vector<uint8_t> visible_;            // passed the Z-test in the last colorInDepth
+    std::vector<uint16_t> zbuf_;              // nearest color-camera depth per cell
+    std::vector<uint32_t> cellOfU_, cellOfV_; // color column -> cell column, row -> cell row offset
+    int zbufW_ = 0;
+    RowWorkers workers_;
+};
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// Region-of-interest support: a crop rectangle plus polygon exclusion masks,
+// compiled once (per config change / resolution) into per-row span lists so
+// the per-frame kernels only touch active pixels.
+//
+// Coordinates in the text specs are normalized to 0..1 so a saved region keeps
+// its meaning across resolution changes.
+//   crop:    "x0,y0,x1,y1"                    (empty = full frame)
+//   exclude: "x,y x,y x,y; x,y x,y x,y ..."   (polygons separated by ';')
+
+// Half-open run of active pixels [x0, x1) on one row.
+struct Span {
+    int x0, x1;
+};
+
+struct RoiSpans {
+    int width = 0;
+    int height = 0;
+    bool full = true;               // true = whole frame active (kernels take the fast path)
+    int activePixels = 0;
+    std::vector<int> rowStart;      // height + 1 offsets into spans
+    std::vector<Span> spans;
+
+    // Span range for row y: spans[rowBegin(y)] .. spans[rowEnd(y) - 1]
+    int rowBegin(int y) const { return rowStart[y]; }
+    int rowEnd(int y) const { return rowStart[y + 1]; }
+};
+
+struct RoiPoint {
+    float x, y;
+};
+
+// Parse "a,b,c,d" into four normalized floats. Returns false if malformed.
+inline bool parseRoiCrop(const std::string& text, float out[4]) {
+    const char* p = text.c_str();
+    for (int i = 0; i < 4; i++) {
+        char* end = nullptr;
+        float v = std::strtof(p, &end);
+        if (end == p) return false;
+        out[i] = std::min(1.0f, std::max(0.0f, v));
+        p = end;
+        while (*p == ' ' || *p == ',') p++;
+    }
+    return true;
+}
+
+// Parse polygon list "x,y x,y x,y; ..." into normalized points.
+// Polygons with fewer than 3 vertices are dropped.
+inline std::vector<std::vector<RoiPoint>> parseRoiPolygons(const std::string& text) {
+    std::vector<std::vector<RoiPoint>> polys;
+    std::vector<RoiPoint> cur;
+    const char* p = text.c_str();
+    auto flush = [&]() {
+        if (cur.size() >= 3) polys.push_back(cur);
+        cur.clear();
+    };
+    while (*p) {
+        while (*p == ' ' || *p == '\t') p++;
+        if (*p == ';') { flush(); p++; continue; }
+        if (!*p) break;
+        char* end = nullptr;
+        float x = std::strtof(p, &end);
+        if (end == p) { p++; continue; }  // skip junk
+        p = end;
+        while (*p == ' ' || *p == ',') p++;
+        float y = std::strtof(p, &end);
+        if (end == p) break;
+        p = end;
+        cur.push_back({std::min(1.0f, std::max(0.0f, x)), std::min(1.0f, std::max(0.0f, y))});
+    }
+    flush();
+    return polys;
+}
+
+// Keep only characters valid in a crop / polygon spec (digits, separators).
+// Also keeps the strings safe to embed in JSON responses and settings.json.
+inline std::string sanitizeRoiSpec(const std::string& text) {
+    std::string out;
+    out.reserve(text.size());
+    for (char c : text) {
+        if ((c >= '0' && c <= '9') || c == '.' || c == ',' || c == ';' || c == ' ' || c == '-')
+            out += c;
+    }
+    return out;
+}
+
+// Append the runs of pixels covered by a normalized polygon on the row whose
+// center is at normalized height fy (even-odd rule, pixel centers).
+// xs is scratch storage reused across calls.
+inline void appendPolygonRowRuns(const std::vector<RoiPoint>& poly, float fy, int width,
+                                 std::vector<float>& xs, std::vector<Span>& out) {
+    xs.clear();
+    size_t n = poly.size();
+    for (size_t i = 0, j = n - 1; i < n; j = i++) {
+        float yi = poly[i].y, yj = poly[j].y;
+        if ((yi > fy) == (yj > fy)) continue;
+        float t = (fy - yi) / (yj - yi);
+        xs.push_back((poly[i].x + t * (poly[j].x - poly[i].x)) * width);
+    }
+    std::sort(xs.begin(), xs.end());
+    for (size_t k = 0; k + 1 < xs.size(); k += 2) {
+        // Pixel x is inside when its center x+0.5 lies within the crossing pair
+        int x0 = std::max(0, static_cast<int>(xs[k] + 0.5f));
+        int x1 = std::min(width, static_cast<int>(xs[k + 1] + 0.5f));
+        if (x1 > x0) out.push_back({x0, x1});
+    }
+}
+
+// Compile crop rectangle and exclusion polygons into per-row spans.
+// Polygons are rasterized at pixel centers with the even-odd rule.
+inline void compileRoiSpans(RoiSpans& roi, int width, int height, bool enabled,
+                            const std::string& cropSpec, const std::string& excludeSpec) {
+    roi.width = width;
+    roi.height = height;
+    roi.spans.clear();
+    roi.rowStart.assign(height + 1, 0);
+
+    float crop[4] = {0.0f, 0.0f, 1.0f, 1.0f};
+    if (enabled && !cropSpec.empty() && !parseRoiCrop(cropSpec, crop)) {
+        crop[0] = 0.0f; crop[1] = 0.0f; crop[2] = 1.0f; crop[3] = 1.0f;
+    }
+    auto polys = enabled ? parseRoiPolygons(excludeSpec) : std::vector<std::vector<RoiPoint>>{};
+
+    int cx0 = static_cast<int>(std::min(crop[0], crop[2]) * width + 0.5f);
+    int cx1 = static_cast<int>(std::max(crop[0], crop[2]) * width + 0.5f);
+    int cy0 = static_cast<int>(std::min(crop[1], crop[3]) * height + 0.5f);
+    int cy1 = static_cast<int>(std::max(crop[1], crop[3]) * height + 0.5f);
+
+    roi.full = !enabled || (cx0 == 0 && cy0 == 0 && cx1 == width && cy1 == height && polys.empty());
+    roi.activePixels = 0;
+
+    std::vector<float> xs;           // polygon edge crossings on the current row
+    std::vector<Span> excluded;      // excluded runs on the current row
+
+    for (int y = 0; y < height; y++) {
+        roi.rowStart[y] = static_cast<int>(roi.spans.size());
+        if (y < cy0 || y >= cy1 || cx0 >= cx1) continue;
+
+        // Collect excluded runs from every polygon at the row center
+        excluded.clear();
+        float fy = (y + 0.5f) / height;
+        for (const auto& poly : polys) appendPolygonRowRuns(poly, fy, width, xs, excluded);
+        std::sort(excluded.begin(), excluded.end(),
+                  [](const Span& a, const Span& b) { return a.x0 < b.x0; });
+
+        // Subtract excluded runs from the crop interval
+        int x = cx0;
+        for (const auto& e : excluded) {
+            if (e.x1 <= x) continue;
+            if (e.x0 >= cx1) break;
+            if (e.x0 > x) roi.spans.push_back({x, e.x0});
+            x = std::max(x, e.x1);
+            if (x >= cx1) break;
+        }
+        if (x < cx1) roi.spans.push_back({x, cx1});
+    }
+    roi.rowStart[height] = static_cast<int>(roi.spans.size());
+
+    if (roi.full) {
+        roi.activePixels = width * height;
+    } else {
+        for (const auto& s : roi.spans) roi.activePixels += s.x1 - s.x0;
+    }
+}
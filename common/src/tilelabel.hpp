@@ -0,0 +1,327 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "blobdetect.hpp"
+#include "depthcolor.hpp"
+
+// Incremental connected-component labeling for mostly static scenes.
+//
+// The mask is divided into kTileSize x kTileSize tiles. Each frame the rows of
+// every tile inside the ROI are compared (memcmp) with the mask the threshold
+// pass wrote in the previous frame, and with the band map in band mode; only
+// tiles that changed are re-labeled. A tile whose mask stays the same but
+// holds foreground is also re-labeled every kRefreshFrames frames (staggered
+// over the tiles) so the depth stats of a still blob follow its depth. Tiles
+// outside the ROI are never looked at. Each tile keeps its own local labels
+// and per-component summaries (BlobInfo partial stats). The summaries of all
+// tiles are then stitched along tile borders with a union-find over tile
+// components, which costs O(components + border pixels of non-empty tiles).
+// Because labeling is local to a tile, a change never forces its neighbors to
+// be re-labeled; stitching picks up the new connectivity.
+//
+// Produces the same blobs as detectAndDrawBlobs, except that the depth stats of
+// unchanged tiles can lag by up to kRefreshFrames frames. The mask outside the
+// ROI must already be background (as the threshold functions write it); the
+// ROI and zone map are taken as fixed until reset().
+class IncrementalLabeler {
+public:
+    static constexpr int kTileSize = 32;
+    static constexpr int kRefreshFrames = 4;
+
+    // Forget all tiles: the next frame is labeled from scratch.
+    void reset() { width_ = 0; height_ = 0; }
+
+    // Same contract as detectAndDrawBlobs (labels must be provided; it is
+    // written for the pixels of blobs that can be kept or split).
+    std::vector<BlobInfo> detect(uint8_t* bgr, int width, int height, int maxBlobPixels,
+                                 const uint16_t* depthMm, int minBlobPixels, const RoiSpans* roi,
+                                 const uint8_t* zoneMap, const uint8_t* bandMap,
+                                 std::vector<int>& labels, int splitStepMm = 0,
+                                 int maxBlobs = 0, bool nearestFirst = false) {
+        if (width != width_ || height != height_ ||
+            labels.size() != static_cast<size_t>(width) * height) {
+            allocate(width, height, roi);
+            labels.assign(static_cast<size_t>(width) * height, 0);
+            labelBase_ = 1;
+        }
+        // Stale labels from earlier frames are always below labelBase_; start over
+        // long before the ids could wrap.
+        if (labelBase_ > (1 << 30)) {
+            labels.assign(labels.size(), 0);
+            labelBase_ = 1;
+        }
+
+        // ---- Re-label only the tiles that changed (or are due for a depth refresh) ----
+        dirtyTiles_ = 0;
+        bool sawWeak = false;
+        frame_++;
+        for (int t = 0; t < tileCount(); t++) {
+            Tile& tile = tiles_[t];
+            if (!tile.active) continue;
+            bool refresh = !tile.comps.empty() && (t + frame_) % kRefreshFrames == 0;
+            if (!tile.valid || refresh || changed(tile, bgr, bandMap)) {
+                labelTile(t, bgr, depthMm, zoneMap, bandMap);
+                keep(tile, bgr, bandMap);
+                tile.valid = true;
+                dirtyTiles_++;
+            }
+            sawWeak = sawWeak || tile.hasWeak;
+        }
+
+        // ---- Stitch tile components across tile borders ----
+        int nodes = 0;
+        for (int t = 0; t < tileCount(); t++) {
+            tiles_[t].nodeBase = nodes;
+            nodes += static_cast<int>(tiles_[t].comps.size());
+        }
+        uf_.init(nodes);
+        for (int ty = 0; ty < tilesY_; ty++) {
+            for (int tx = 0; tx < tilesX_; tx++) {
+                int t = ty * tilesX_ + tx;
+                if (tiles_[t].comps.empty()) continue;
+                if (tx + 1 < tilesX_ && !tiles_[t + 1].comps.empty())
+                    stitch(t, t + 1, true, zoneMap, bandMap);
+                if (ty + 1 < tilesY_ && !tiles_[t + tilesX_].comps.empty())
+                    stitch(t, t + tilesX_, false, zoneMap, bandMap);
+            }
+        }
+
+        // ---- Merge component summaries per stitched root ----
+        rootToBlob_.assign(nodes, -1);
+        blobs_.clear();
+        blobStrong_.clear();
+        for (int t = 0; t < tileCount(); t++) {
+            const Tile& tile = tiles_[t];
+            for (size_t c = 0; c < tile.comps.size(); c++) {
+                int root = uf_.find(tile.nodeBase + static_cast<int>(c));
+                int& bi = rootToBlob_[root];
+                if (bi < 0) {
+                    bi = static_cast<int>(blobs_.size());
+                    blobs_.push_back(tile.comps[c]);
+                    blobs_.back().label = labelBase_ + root;
+                    blobStrong_.push_back(tile.strong[c]);
+                } else {
+                    mergeBlobStats(blobs_[bi], tile.comps[c]);
+                    blobStrong_[bi] |= tile.strong[c];
+                }
+            }
+        }
+
+        // Hysteresis: weak pixels of kept components turn black, weak-only components white
+        if (sawWeak) {
+            for (int t = 0; t < tileCount(); t++) {
+                if (!tiles_[t].hasWeak) continue;
+                forTilePixels(t, [&](int idx, int local) {
+                    uint8_t v = blobStrong_[blobOf(t, local)] ? 0 : 255;
+                    bgr[idx * 3 + 0] = bgr[idx * 3 + 1] = bgr[idx * 3 + 2] = v;
+                });
+            }
+        }
+
+        // Label image for the blobs the next stages may look at (contours, splitting)
+        need_.assign(blobs_.size(), 0);
+        for (size_t i = 0; i < blobs_.size(); i++) {
+            const BlobInfo& b = blobs_[i];
+            need_[i] = blobStrong_[i] && b.pixelCount >= minBlobPixels &&
+                       (b.pixelCount <= maxBlobPixels || splitStepMm > 0);
+        }
+        for (int t = 0; t < tileCount(); t++) {
+            bool any = false;
+            for (size_t c = 0; c < tiles_[t].comps.size() && !any; c++)
+                any = need_[blobOf(t, static_cast<int>(c) + 1)] != 0;
+            if (!any) continue;
+            forTilePixels(t, [&](int idx, int local) {
+                int bi = blobOf(t, local);
+                if (need_[bi]) labels[idx] = blobs_[bi].label;
+            });
+        }
+
+        // Drop weak-only components, then the shared split / filter / top-K / draw stage
+        if (sawWeak) {
+            size_t w = 0;
+            for (size_t i = 0; i < blobs_.size(); i++)
+                if (blobStrong_[i]) blobs_[w++] = std::move(blobs_[i]);
+            blobs_.resize(w);
+        }
+        int nextLabel = labelBase_ + nodes;
+        auto result = selectAndDrawBlobs(bgr, width, height, blobs_, labels, nextLabel,
+                                         maxBlobPixels, depthMm, minBlobPixels, splitStepMm,
+                                         maxBlobs, nearestFirst);
+        labelBase_ = nextLabel + 1;
+        return result;
+    }
+
+    int tileCount() const { return tilesX_ * tilesY_; }
+    int dirtyTiles() const { return dirtyTiles_; }   // tiles re-labeled in the last frame
+
+private:
+    struct Tile {
+        int x0, y0, x1, y1;             // pixel bounds, [x0, x1) x [y0, y1)
+        bool active = true;             // intersects the ROI
+        bool valid = false;
+        bool hasWeak = false;
+        int nodeBase = 0;               // first stitching node of this tile
+        std::vector<BlobInfo> comps;    // local component i + 1 -> partial stats
+        std::vector<uint8_t> strong;    // local component contains a black pixel
+    };
+
+    static bool isForeground(const uint8_t* px) {
+        uint8_t v = px[0];
+        return (v == 0 || v == kWeakForeground) && px[1] == v && px[2] == v;
+    }
+
+    void allocate(int width, int height, const RoiSpans* roi) {
+        width_ = width;
+        height_ = height;
+        tilesX_ = (width + kTileSize - 1) / kTileSize;
+        tilesY_ = (height + kTileSize - 1) / kTileSize;
+        tiles_.assign(tilesX_ * tilesY_, Tile());
+        for (int ty = 0; ty < tilesY_; ty++) {
+            for (int tx = 0; tx < tilesX_; tx++) {
+                Tile& tile = tiles_[ty * tilesX_ + tx];
+                tile.x0 = tx * kTileSize;
+                tile.y0 = ty * kTileSize;
+                tile.x1 = tile.x0 + kTileSize < width ? tile.x0 + kTileSize : width;
+                tile.y1 = tile.y0 + kTileSize < height ? tile.y0 + kTileSize : height;
+                tile.active = !roi || roi->full || intersects(*roi, tile);
+            }
+        }
+        local_.assign(static_cast<size_t>(width) * height, 0);
+        prevBgr_.assign(static_cast<size_t>(width) * height * 3, 0);
+        prevBand_.assign(static_cast<size_t>(width) * height, 0);
+        frame_ = 0;
+    }
+
+    static bool intersects(const RoiSpans& roi, const Tile& tile) {
+        for (int y = tile.y0; y < tile.y1; y++)
+            for (int s = roi.rowBegin(y); s < roi.rowEnd(y); s++)
+                if (roi.spans[s].x0 < tile.x1 && roi.spans[s].x1 > tile.x0) return true;
+        return false;
+    }
+
+    // Whether the tile's mask (or band ids) differ from the last time it was labeled
+    bool changed(const Tile& tile, const uint8_t* bgr, const uint8_t* bandMap) const {
+        size_t w = static_cast<size_t>(tile.x1 - tile.x0);
+        for (int y = tile.y0; y < tile.y1; y++) {
+            size_t idx = static_cast<size_t>(y) * width_ + tile.x0;
+            if (std::memcmp(bgr + idx * 3, prevBgr_.data() + idx * 3, w * 3) != 0) return true;
+            if (bandMap && std::memcmp(bandMap + idx, prevBand_.data() + idx, w) != 0) return true;
+        }
+        return false;
+    }
+
+    // Remember the mask the tile was labeled from (before hysteresis and drawing)
+    void keep(const Tile& tile, const uint8_t* bgr, const uint8_t* bandMap) {
+        size_t w = static_cast<size_t>(tile.x1 - tile.x0);
+        for (int y = tile.y0; y < tile.y1; y++) {
+            size_t idx = static_cast<size_t>(y) * width_ + tile.x0;
+            std::memcpy(prevBgr_.data() + idx * 3, bgr + idx * 3, w * 3);
+            if (bandMap) std::memcpy(prevBand_.data() + idx, bandMap + idx, w);
+        }
+    }
+
+    // Two-pass labeling confined to one tile; fills local_ and the tile summaries.
+    void labelTile(int t, const uint8_t* bgr, const uint16_t* depthMm,
+                   const uint8_t* zoneMap, const uint8_t* bandMap) {
+        Tile& tile = tiles_[t];
+        tile.comps.clear();
+        tile.strong.clear();
+        tile.hasWeak = false;
+        auto sameGroup = [&](int a, int b) {
+            return (!zoneMap || zoneMap[a] == zoneMap[b]) && (!bandMap || bandMap[a] == bandMap[b]);
+        };
+
+        tileUf_.parent.clear();
+        tileUf_.rank.clear();
+        tileUf_.grow(0);
+        int next = 1;
+        for (int y = tile.y0; y < tile.y1; y++) {
+            for (int x = tile.x0; x < tile.x1; x++) {
+                int idx = y * width_ + x;
+                if (!isForeground(bgr + idx * 3)) { local_[idx] = 0; continue; }
+                int up = (y > tile.y0 && local_[idx - width_] && sameGroup(idx, idx - width_))
+                             ? local_[idx - width_] : 0;
+                int left = (x > tile.x0 && local_[idx - 1] && sameGroup(idx, idx - 1))
+                               ? local_[idx - 1] : 0;
+                if (!up && !left) {
+                    tileUf_.grow(next);
+                    local_[idx] = static_cast<uint16_t>(next++);
+                } else {
+                    local_[idx] = static_cast<uint16_t>(up ? up : left);
+                    if (up && left) tileUf_.unite(up, left);
+                }
+            }
+        }
+        if (next == 1) return;
+
+        compactOf_.assign(next, 0);
+        for (int y = tile.y0; y < tile.y1; y++) {
+            for (int x = tile.x0; x < tile.x1; x++) {
+                int idx = y * width_ + x;
+                if (!local_[idx]) continue;
+                int root = tileUf_.find(local_[idx]);
+                if (!compactOf_[root]) {
+                    tile.comps.push_back(startBlob(x, y, 0, zoneMap ? zoneMap[idx] : 0,
+                                                   bandMap ? bandMap[idx] : 0));
+                    tile.strong.push_back(0);
+                    compactOf_[root] = static_cast<uint16_t>(tile.comps.size());
+                }
+                int c = compactOf_[root];
+                local_[idx] = static_cast<uint16_t>(c);
+                accumulateBlobPixel(tile.comps[c - 1], x, y, idx, depthMm);
+                if (bgr[idx * 3] == 0) tile.strong[c - 1] = 1;
+                else tile.hasWeak = true;
+            }
+        }
+    }
+
+    // Unite the components of tile a with those of its right (or lower) neighbor b
+    // wherever foreground pixels of the same zone / band face each other.
+    void stitch(int a, int b, bool right, const uint8_t* zoneMap, const uint8_t* bandMap) {
+        const Tile& ta = tiles_[a];
+        int n = right ? ta.y1 - ta.y0 : ta.x1 - ta.x0;
+        for (int i = 0; i < n; i++) {
+            int ia = right ? (ta.y0 + i) * width_ + ta.x1 - 1 : (ta.y1 - 1) * width_ + ta.x0 + i;
+            int ib = right ? ia + 1 : ia + width_;
+            int la = local_[ia], lb = local_[ib];
+            if (!la || !lb) continue;
+            if (zoneMap && zoneMap[ia] != zoneMap[ib]) continue;
+            if (bandMap && bandMap[ia] != bandMap[ib]) continue;
+            uf_.unite(ta.nodeBase + la - 1, tiles_[b].nodeBase + lb - 1);
+        }
+    }
+
+    // Blob index of local component `local` (1-based) of tile t
+    int blobOf(int t, int local) { return rootToBlob_[uf_.find(tiles_[t].nodeBase + local - 1)]; }
+
+    template <typename Fn>
+    void forTilePixels(int t, Fn&& fn) {
+        const Tile& tile = tiles_[t];
+        for (int y = tile.y0; y < tile.y1; y++) {
+            for (int x = tile.x0; x < tile.x1; x++) {
+                int idx = y * width_ + x;
+                if (local_[idx]) fn(idx, local_[idx]);
+            }
+        }
+    }
+
+    int width_ = 0, height_ = 0;
+    int tilesX_ = 0, tilesY_ = 0;
+    int labelBase_ = 1;
+    int dirtyTiles_ = 0;
+    unsigned frame_ = 0;
+    std::vector<Tile> tiles_;
+    std::vector<uint8_t> prevBgr_;      // mask each tile was last labeled from
+    std::vector<uint8_t> prevBand_;
+    std::vector<uint16_t> local_;       // per pixel: component id local to its tile
+    UnionFind tileUf_;
+    std::vector<uint16_t> compactOf_;
+    UnionFind uf_;
+    std::vector<int> rootToBlob_;
+    std::vector<BlobInfo> blobs_;
+    std::vector<uint8_t> blobStrong_;
+    std::vector<uint8_t> need_;
+};
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// What a tracker needs to carry on where it left off: the next serial and the
+// last position of every published track. Kept by the frame loop across
+// pipeline restarts and served on /checkpoint.
+struct TrackerState {
+    struct Track {
+        int serial;
+        float x, y;          // centroid (px)
+        float vx, vy;        // filtered velocity (px/s)
+        float depthMm;
+        int pixelCount;
+        int zone;
+        int band;
+    };
+    int nextSerial = 1;
+    std::vector<Track> tracks;
+};
+
+// The states of all trackers of a run, with the frame size their positions
+// refer to (a restart may change the depth resolution).
+struct TrackerCheckpoint {
+    long long ms = 0;               // time of the latest frame
+    int width = 0, height = 0;      // 0 = nothing saved yet
+    std::string bands;              // band spec of the band trackers
+    TrackerState single;
+    std::vector<TrackerState> bandStates;
+};
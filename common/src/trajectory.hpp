@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Recent path of each tracked blob: a fixed-capacity ring of samples per
+// track, carved out of one pool so tracks starting and ending don't allocate.
+// Served on /tracks, so a client that connects late still gets the last
+// couple of seconds of every hand.
+struct TrackSample {
+    long long ms;       // frame time
+    float x, y;         // centroid (px)
+    uint16_t depthMm;   // average depth (0 = none)
+};
+
+class TrajectoryPool {
+public:
+    static constexpr int kCapacity = 64;   // samples per track (~2 s at 30 fps)
+
+    // A free slot (emptied); the pool grows by doubling when all are taken.
+    int acquire() {
+        if (free_.empty()) grow();
+        int slot = free_.back();
+        free_.pop_back();
+        head_[slot] = 0;
+        count_[slot] = 0;
+        return slot;
+    }
+
+    void release(int slot) {
+        if (slot >= 0) free_.push_back(slot);
+    }
+
+    // Append a sample, overwriting the oldest once the ring is full.
+    void push(int slot, const TrackSample& s) {
+        samples_[static_cast<size_t>(slot) * kCapacity + (head_[slot] + count_[slot]) % kCapacity] = s;
+        if (count_[slot] < kCapacity) count_[slot]++;
+        else head_[slot] = (head_[slot] + 1) % kCapacity;
+    }
+
+    int size(int slot) const { return count_[slot]; }
+
+    // i = 0 is the oldest sample
+    const TrackSample& at(int slot, int i) const {
+        return samples_[static_cast<size_t>(slot) * kCapacity + (head_[slot] + i) % kCapacity];
+    }
+
+private:
+    void grow() {
+        int slots = static_cast<int>(head_.size());
+        int more = slots > 0 ? slots : kInitialSlots;
+        samples_.resize(static_cast<size_t>(slots + more) * kCapacity);
+        head_.resize(slots + more, 0);
+        count_.resize(slots + more, 0);
+        free_.reserve(slots + more);
+        for (int s = slots + more - 1; s >= slots; s--) free_.push_back(s);
+    }
+
+    static constexpr int kInitialSlots = 16;
+
+    std::vector<TrackSample> samples_;
+    std::vector<int> head_;
+    std::vector<int> count_;
+    std::vector<int> free_;
+};
+
+// Copy of the histories of all published tracks, handed from the frame loop
+// to the web server: samples of track i are samples[begin, begin + count).
+struct TrackHistorySnapshot {
+    struct Track {
+        int band;
+        int id;
+        size_t begin, count;
+    };
+    long long ms = 0;   // time of the latest frame
+    std::vector<Track> tracks;
+    std::vector<TrackSample> samples;
+
+    void clear(long long now) {
+        ms = now;
+        tracks.clear();
+        samples.clear();
+    }
+};
@@ -55,6 +55,11 @@ inline const std::string kSharedCss = R"HTML(
   .help-box button:hover { background: #666; }
   h2 { font-size: 15px; margin: 12px 0 4px; color: #8cf; width: 100%; }
   .unsupported { display: none !important; }
+  input[type=text] { background: #1a1a2e; color: #eee; border: 1px solid #444; border-radius: 4px;
+                     padding: 4px 8px; font-size: 13px; font-family: monospace; }
+  .btn { background: #444; color: #eee; border: none; border-radius: 4px;
+         padding: 6px 12px; cursor: pointer; font-size: 13px; }
+  .btn:hover { background: #666; }
 )HTML";
 
 // ---- Help overlay HTML ----
@@ -82,6 +87,10 @@ inline const std::string kSharedControls = R"HTML(
     <input id="threshSlider" class="slider" type="range" min="200" max="1200" step="10" value="550">
   </label>
   <span id="threshVal" class="val">550 mm</span>
+  <label>Grow<span class="help-btn" onclick="showHelp('Grow (Hysteresis)','Second, weaker threshold this many mm beyond the main one. Pixels in that band join a blob only when connected to pixels closer than the threshold, so blob edges stop flickering when a hand hovers near the threshold. 0 = off.')">?</span>:
+    <input id="weakSlider" class="slider" type="range" min="0" max="300" step="10" value="0" style="width:100px">
+  </label>
+  <span id="weakVal" class="val">+0 mm</span>
   <label>Dilate<span class="help-btn" onclick="showHelp('Dilate','Expands black regions by N pixels. Helps connect nearby blobs.')">?</span>:
     <input id="dilateSlider" class="slider" type="range" min="0" max="10" step="1" value="0" style="width:100px">
   </label>
@@ -185,6 +194,158 @@ inline const std::string kSharedControls = R"HTML(
 </div>
 )HTML";
 
+// ---- Region of interest controls (crop + exclusion polygons) ----
+inline const std::string kSharedRegionControls = R"HTML(
+<div class="controls">
+  <div class="toggle">
+    <label class="switch">
+      <input id="roiToggle" type="checkbox">
+      <span class="slider-track"></span>
+    </label>
+    <span>Region<span class="help-btn" onclick="showHelp('Region of Interest','Only pixels inside the crop rectangle and outside the exclusion polygons are processed. Coordinates are fractions of the image (0..1), e.g. crop 0.1,0.1,0.9,0.9. Polygons are x,y pairs separated by spaces, polygons separated by semicolons. Shift+click the depth view to add a vertex to the last polygon.')">?</span></span>
+  </div>
+  <label>Crop:
+    <input id="roiCrop" type="text" placeholder="x0,y0,x1,y1" style="width:150px">
+  </label>
+  <label>Exclude:
+    <input id="roiExclude" type="text" placeholder="x,y x,y x,y; ..." style="width:320px">
+  </label>
+  <button id="roiNewPoly" class="btn">New Polygon</button>
+  <button id="roiApply" class="btn">Apply</button>
+</div>
+<div class="controls">
+  <div class="toggle">
+    <label class="switch">
+      <input id="zonesToggle" type="checkbox">
+      <span class="slider-track"></span>
+    </label>
+    <span>Zones<span class="help-btn" onclick="showHelp('Zones','Split the image into zones, each with its own depth band. Format: near-far: x,y x,y x,y; with depths in mm and coordinates as fractions of the image. Zones are numbered in order (later zones win where they overlap); pixels outside every zone use the main threshold. Blobs never span two zones, and per-zone pixel count, blob count and nearest depth are published on /events.')">?</span></span>
+  </div>
+  <label>Spec:
+    <input id="zonesSpec" type="text" placeholder="400-700: 0,0 0.5,0 0.5,1 0,1; ..." style="width:420px">
+  </label>
+  <button id="zonesApply" class="btn">Apply</button>
+</div>
+<div class="controls">
+  <div class="toggle">
+    <label class="switch">
+      <input id="bandsToggle" type="checkbox">
+      <span class="slider-track"></span>
+    </label>
+    <span>Bands<span class="help-btn" onclick="showHelp('Depth Bands','Several depth bands segmented from the same frame, e.g. 400-550, 550-700 for hover and touch layers. Each band is labeled and tracked separately (own blob ids) and published as its own layer on /events and /blobs.bin. Replaces the threshold and zones while enabled; dilation and Grow are not applied.')">?</span></span>
+  </div>
+  <label>Bands (mm):
+    <input id="bandsSpec" type="text" placeholder="400-550, 550-700" style="width:200px">
+  </label>
+  <button id="bandsApply" class="btn">Apply</button>
+</div>
+<div class="controls">
+  <div class="toggle">
+    <label class="switch">
+      <input id="planeToggle" type="checkbox">
+      <span class="slider-track"></span>
+    </label>
+    <span>Surface<span class="help-btn" onclick="showHelp('Surface Plane','Fits the table or floor plane from the depth image and segments by height above it instead of the fixed threshold, so a tilted camera works. Min/Max set the height band above the surface that counts as foreground. The plane is refitted automatically when the camera is bumped. Intrinsics (fx,fy,cx,cy in depth pixels) override the device calibration; leave empty for automatic.')">?</span></span>
+  </div>
+  <label>Min:
+    <input id="planeMin" class="slider" type="range" min="0" max="100" step="5" value="15" style="width:100px">
+  </label>
+  <span id="planeMinVal" class="val">15 mm</span>
+  <label>Max:
+    <input id="planeMax" class="slider" type="range" min="20" max="600" step="10" value="200" style="width:100px">
+  </label>
+  <span id="planeMaxVal" class="val">200 mm</span>
+  <label>Intrinsics:
+    <input id="planeIntr" type="text" placeholder="auto" style="width:150px">
+  </label>
+  <button id="planeRefit" class="btn">Refit</button>
+  <span id="planeInfo" class="fps"></span>
+</div>
+)HTML";
+
+// ---- Blob shape controls (outlines) ----
+inline const std::string kSharedShapeControls = R"HTML(
+<div class="controls">
+  <div class="toggle">
+    <label class="switch">
+      <input id="contoursToggle" type="checkbox">
+      <span class="slider-track"></span>
+    </label>
+    <span>Outlines<span class="help-btn" onclick="showHelp('Blob Outlines','Traces the border of every blob and simplifies it to a polygon; vertices are published with each blob on /events (contour: x0,y0,x1,y1,...) and /blobs.bin. Tolerance is the largest distance in pixels the polygon may deviate from the traced border: higher values give fewer vertices. Vertices caps each outline (0 = no limit): the points that deviate most are kept first. Tips finds up to that many extremities (fingertips) per blob from its convex hull, each with its depth and an id that stays with it while it is tracked; 0 turns it off.')">?</span></span>
+  </div>
+  <label>Tolerance:
+    <input id="contourEps" class="slider" type="range" min="1" max="20" step="1" value="2" style="width:100px">
+  </label>
+  <span id="contourEpsVal" class="val">2 px</span>
+  <label>Vertices:
+    <input id="contourVerts" class="slider" type="range" min="0" max="256" step="8" value="64" style="width:100px">
+  </label>
+  <span id="contourVertsVal" class="val">64</span>
+  <label>Tips:
+    <input id="maxTips" class="slider" type="range" min="0" max="10" step="1" value="0" style="width:80px">
+  </label>
+  <span id="maxTipsVal" class="val">0</span>
+  <label>Split<span class="help-btn" onclick="showHelp('Split Blobs','Blobs larger than the max blob size are normally dropped. With Split above 0 they are instead cut apart wherever neighboring pixels differ in depth by more than this many mm, e.g. two people standing side by side or a hand touching an object, and the parts are kept if they fit the size limits. Only the oversized blob areas are processed.')">?</span>:
+    <input id="splitStep" class="slider" type="range" min="0" max="200" step="5" value="0" style="width:100px">
+  </label>
+  <span id="splitStepVal" class="val">off</span>
+  <label>Keep<span class="help-btn" onclick="showHelp('Keep Blobs','Limits how many blobs are reported per frame, keeping the largest or the nearest ones (by average depth). This bounds the work and the output even for very noisy frames. 0 keeps all.')">?</span>:
+    <input id="topK" class="slider" type="range" min="0" max="20" step="1" value="0" style="width:80px">
+  </label>
+  <span id="topKVal" class="val">all</span>
+  <select id="blobRank">
+    <option value="largest">largest</option>
+    <option value="nearest">nearest</option>
+  </select>
+  <label title="Re-label only the parts of the mask that changed since the last frame (same results, less work for mostly static scenes)">
+    <input id="incLabel" type="checkbox"> Incremental
+  </label>
+  <label>Match<span class="help-btn" onclick="showHelp('Blob Matching','How blobs are matched to the previous frame. Greedy pairs the closest blobs first. Optimal minimizes the total distance over all blobs at once, so ids (and notes) swap less when blobs pass close to each other in crowded scenes.')">?</span>:
+    <select id="blobAssign">
+      <option value="greedy">greedy</option>
+      <option value="optimal">optimal</option>
+    </select>
+  </label>
+  <label>Gate<span class="help-btn" onclick="showHelp('Match Gate','How far a blob may be from where its track was predicted and still keep its id, in mm at the depth of the blob, so near and far hands are treated alike at any resolution. The gate also widens while the motion is uncertain (fast or new blobs). 0 uses a fixed radius of 80 pixels.')">?</span>:
+    <input id="matchGate" type="number" min="0" max="500" step="10" value="0" style="width:50px">
+  </label>
+  <label>Confirm<span class="help-btn" onclick="showHelp('Track Lifecycle','Confirm is how many frames in a row a new blob must be seen before it is reported (and sounds), which filters one-frame noise; 1 reports it immediately. Coast is how many frames a blob that disappears keeps its id, moving along its predicted path, before it ends: a dropped or noisy depth frame then no longer ends a touch and starts a new one. Coasting blobs report how many frames they have been missing.')">?</span>:
+    <input id="confirmFrames" type="number" min="1" max="30" value="2" style="width:40px">
+  </label>
+  <label>Coast:
+    <input id="coastFrames" type="number" min="0" max="30" value="3" style="width:40px">
+  </label>
+  <label>
+    <input id="deltaPublish" type="checkbox"> Delta<span class="help-btn" onclick="showHelp('Delta Publishing','Only sends blobs on /events and /blobs.bin when one starts or ends, moves more than the given pixels or mm in depth since it was last sent, a fingertip appears, ends or moves more than the given pixels, a blob is lost or found again, or a zone changes its blob count or nearest depth; plus a full update every Keyframe ms so clients can resync. Outlines alone do not trigger an update. This is not a stream of changes: every update still lists all blobs, so one moving blob resends them all. Saves work and traffic while the scene is still.')">?</span>
+  </label>
+  <label>px:
+    <input id="deltaPx" type="number" min="0" max="100" value="2" style="width:40px">
+  </label>
+  <label>mm:
+    <input id="deltaMm" type="number" min="0" max="500" value="10" style="width:45px">
+  </label>
+  <label>Keyframe:
+    <input id="keyframeMs" type="number" min="100" max="10000" step="100" value="1000" style="width:55px">
+  </label>
+</div>
+<div class="controls">
+  <div class="toggle">
+    <label class="switch">
+      <input id="gesturesToggle" type="checkbox">
+      <span class="slider-track"></span>
+    </label>
+    <span>Gestures<span class="help-btn" onclick="showHelp('Gestures','Recognizes gestures on the tracked blobs and sends them to every client on /events (event: gesture) and /gestures.bin. Tap: a blob that comes and goes within Tap ms without moving more than Still px. Hold: a blob that stays within Still px for Hold ms. Swipe: a blob moving faster than Speed px/s for at least Swipe px, with its direction. Circle: a full turn, clockwise or counter-clockwise. Pinch: with exactly two blobs, every Pinch % change of their distance.')">?</span></span>
+  </div>
+  <label>Tap: <input id="gTap" type="number" min="50" max="2000" step="50" style="width:50px"></label>
+  <label>Hold: <input id="gHold" type="number" min="100" max="5000" step="100" style="width:50px"></label>
+  <label>Still: <input id="gStill" type="number" min="1" max="200" style="width:40px"></label>
+  <label>Speed: <input id="gSpeed" type="number" min="50" max="10000" step="50" style="width:55px"></label>
+  <label>Swipe: <input id="gSwipe" type="number" min="5" max="1000" step="5" style="width:45px"></label>
+  <label>Pinch: <input id="gPinch" type="number" min="1" max="100" style="width:40px"></label>
+  <span id="gestureInfo" class="fps"></span>
+</div>
+)HTML";
+
 // ---- Images section ----
 inline const std::string kSharedImages = R"HTML(
 <div class="images">
@@ -210,6 +371,8 @@ inline const std::string kSharedSoundJs = R"HTML(
   const threshToggle = document.getElementById('threshToggle');
   const threshSlider = document.getElementById('threshSlider');
   const threshVal = document.getElementById('threshVal');
+  const weakSlider = document.getElementById('weakSlider');
+  const weakVal = document.getElementById('weakVal');
   const dilateSlider = document.getElementById('dilateSlider');
   const dilateVal = document.getElementById('dilateVal');
   const blobToggle = document.getElementById('blobToggle');
@@ -291,7 +454,7 @@ inline const std::string kSharedSoundJs = R"HTML(
     wholetone:   [0,2,4,6,8,10]
   };
 
-  function startTone(freq, blobId, cx, cy) {
+  function startTone(freq, blobId, pos) {
     if (!audioCtx) audioCtx = new AudioContext();
     if (audioCtx.state === 'suspended') audioCtx.resume();
     if (!masterGain) {
@@ -308,7 +471,7 @@ inline const std::string kSharedSoundJs = R"HTML(
     g.gain.exponentialRampToValueAtTime(0.001, audioCtx.currentTime + decay);
     osc.connect(g).connect(masterGain);
     osc.start();
-    activeTones.set(blobId, {osc: osc, gain: g, startTime: audioCtx.currentTime, cx: cx, cy: cy});
+    activeTones.set(blobId, {osc: osc, gain: g, startTime: audioCtx.currentTime, pos: pos});
   }
 
   function cancelPending(blobId) {
@@ -371,18 +534,17 @@ inline const std::string kSharedSoundJs = R"HTML(
       const delayMs = Math.max(0, (nextBeat - now) * 1000);
       cancelPending(b.id);
       const fq = freq;
-      const cx = b.cx;
-      const cy = b.cy;
+      const pos = b.xyz;
       const bid = b.id;
       console.log(label + ' id=' + bid + ' Mode=' + currentMode + ' raw=' + rawFreq.toFixed(2) + ' played=' + fq.toFixed(2) + info + ' qDelay=' + delayMs.toFixed(0) + 'ms');
       const tid = setTimeout(function() {
         pendingTones.delete(bid);
-        startTone(fq, bid, cx, cy);
+        startTone(fq, bid, pos);
       }, delayMs);
       pendingTones.set(b.id, tid);
     } else {
       console.log(label + ' id=' + b.id + ' Mode=' + currentMode + ' raw=' + rawFreq.toFixed(2) + ' played=' + freq.toFixed(2) + info);
-      startTone(freq, b.id, b.cx, b.cy);
+      startTone(freq, b.id, b.xyz);
     }
   }
 
@@ -395,12 +557,12 @@ inline const std::string kSharedSoundJs = R"HTML(
       const existing = activeTones.get(b.id);
       if (!existing && !pendingTones.has(b.id)) {
         triggerTone(b, j, 'START');
-      } else if (existing && moveThresh > 0) {
-        const dx = b.cx - existing.cx;
-        const dy = b.cy - existing.cy;
-        const pxDist = Math.sqrt(dx * dx + dy * dy);
-        const depth = b.avg > 0 ? b.avg : 500;
-        const mmDist = pxDist * depth / 640;
+      } else if (existing && moveThresh > 0 && b.xyz[2] > 0 && existing.pos[2] > 0) {
+        // Camera-space distance (mm) from where the tone started
+        const dx = b.xyz[0] - existing.pos[0];
+        const dy = b.xyz[1] - existing.pos[1];
+        const dz = b.xyz[2] - existing.pos[2];
+        const mmDist = Math.sqrt(dx * dx + dy * dy + dz * dz);
         if (mmDist > moveThresh) {
           stopTone(b.id);
           triggerTone(b, j, 'MOVE');
@@ -444,6 +606,18 @@ inline const std::string kSharedSoundJs = R"HTML(
         dotsCtx.arc(b.cx, b.cy, r, 0, 2 * Math.PI);
         dotsCtx.fillStyle = '#0f0';
         dotsCtx.fill();
+        if (b.contour && b.contour.length >= 6) {
+          dotsCtx.beginPath();
+          dotsCtx.moveTo(b.contour[0], b.contour[1]);
+          for (let i = 2; i < b.contour.length; i += 2) dotsCtx.lineTo(b.contour[i], b.contour[i + 1]);
+          dotsCtx.closePath();
+          dotsCtx.strokeStyle = '#0f0';
+          dotsCtx.stroke();
+        }
+        if (b.tips) {
+          dotsCtx.fillStyle = '#f0f';
+          for (const t of b.tips) dotsCtx.fillRect(t.x - 3, t.y - 3, 6, 6);
+        }
       }
     }
   }
@@ -460,6 +634,7 @@ inline const std::string kSharedSoundJs = R"HTML(
     stopAllTones();
     evtSource = new EventSource('/events');
     evtSource.onmessage = onSseMessage;
+    evtSource.addEventListener('gesture', onGesture);
   }
 
   function stopDotsStream() {
@@ -514,6 +689,10 @@ inline const std::string kSharedHandlersJs = R"HTML(
     threshVal.textContent = threshSlider.value + ' mm';
     fetch('/threshold?value=' + threshSlider.value);
   });
+  weakSlider.addEventListener('input', function() {
+    weakVal.textContent = '+' + weakSlider.value + ' mm';
+    fetch('/threshold?weak=' + weakSlider.value);
+  });
   dilateSlider.addEventListener('input', function() {
     dilateVal.textContent = dilateSlider.value;
     fetch('/threshold?dilate=' + dilateSlider.value);
@@ -531,6 +710,204 @@ inline const std::string kSharedHandlersJs = R"HTML(
   });
 )HTML";
 
+// ---- Shared JS: region of interest ----
+inline const std::string kSharedRegionJs = R"HTML(
+  const roiToggle = document.getElementById('roiToggle');
+  const roiCrop = document.getElementById('roiCrop');
+  const roiExclude = document.getElementById('roiExclude');
+  function showRoi(d) {
+    roiToggle.checked = d.enabled;
+    roiCrop.value = d.crop;
+    roiExclude.value = d.exclude;
+  }
+  function sendRoi() {
+    fetch('/roi?enabled=' + (roiToggle.checked ? '1' : '0') +
+          '&crop=' + encodeURIComponent(roiCrop.value) +
+          '&exclude=' + encodeURIComponent(roiExclude.value))
+      .then(r=>r.json()).then(showRoi);
+  }
+  roiToggle.addEventListener('change', sendRoi);
+  document.getElementById('roiApply').addEventListener('click', sendRoi);
+  document.getElementById('roiNewPoly').addEventListener('click', function() {
+    const v = roiExclude.value.trim();
+    if (v.length > 0 && !v.endsWith(';')) roiExclude.value = v + '; ';
+  });
+  // Shift+click on the (mirrored) depth view appends a vertex in normalized coords
+  document.querySelector('.depth-wrap').addEventListener('click', function(e) {
+    if (!e.shiftKey) return;
+    const r = e.currentTarget.getBoundingClientRect();
+    const x = 1.0 - (e.clientX - r.left) / r.width;
+    const y = (e.clientY - r.top) / r.height;
+    const v = roiExclude.value.trim();
+    const sep = (v.length === 0 || v.endsWith(';')) ? '' : ' ';
+    roiExclude.value = v + sep + x.toFixed(3) + ',' + y.toFixed(3);
+  });
+  fetch('/roi').then(r=>r.json()).then(showRoi);
+
+  const zonesToggle = document.getElementById('zonesToggle');
+  const zonesSpec = document.getElementById('zonesSpec');
+  function showZones(d) {
+    zonesToggle.checked = d.enabled;
+    zonesSpec.value = d.spec;
+  }
+  function sendZones() {
+    fetch('/zones?enabled=' + (zonesToggle.checked ? '1' : '0') +
+          '&spec=' + encodeURIComponent(zonesSpec.value))
+      .then(r=>r.json()).then(showZones);
+  }
+  zonesToggle.addEventListener('change', sendZones);
+  document.getElementById('zonesApply').addEventListener('click', sendZones);
+  fetch('/zones').then(r=>r.json()).then(showZones);
+
+  const bandsToggle = document.getElementById('bandsToggle');
+  const bandsSpec = document.getElementById('bandsSpec');
+  function showBands(d) {
+    bandsToggle.checked = d.enabled;
+    bandsSpec.value = d.spec;
+  }
+  function sendBands() {
+    fetch('/bands?enabled=' + (bandsToggle.checked ? '1' : '0') +
+          '&spec=' + encodeURIComponent(bandsSpec.value))
+      .then(r=>r.json()).then(showBands);
+  }
+  bandsToggle.addEventListener('change', sendBands);
+  document.getElementById('bandsApply').addEventListener('click', sendBands);
+  fetch('/bands').then(r=>r.json()).then(showBands);
+
+  const planeToggle = document.getElementById('planeToggle');
+  const planeMin = document.getElementById('planeMin');
+  const planeMax = document.getElementById('planeMax');
+  const planeIntr = document.getElementById('planeIntr');
+  const planeInfo = document.getElementById('planeInfo');
+  function showPlane(d) {
+    planeToggle.checked = d.enabled;
+    planeMin.value = d.min;
+    planeMax.value = d.max;
+    document.getElementById('planeMinVal').textContent = d.min + ' mm';
+    document.getElementById('planeMaxVal').textContent = d.max + ' mm';
+    if (document.activeElement !== planeIntr) planeIntr.value = d.intrinsics;
+    const p = d.plane;
+    if (!d.enabled) planeInfo.textContent = '';
+    else if (p.valid) planeInfo.textContent = 'tilt ' + p.tiltDeg.toFixed(1) + '\u00b0, ' +
+      Math.round(p.d) + ' mm, ' + Math.round(100 * p.inliers / Math.max(1, p.samples)) + '% inliers';
+    else planeInfo.textContent = p.fitting ? 'fitting...' : 'no plane';
+  }
+  function planeQuery(q) { fetch('/plane' + q).then(r=>r.json()).then(showPlane); }
+  planeToggle.addEventListener('change', function() {
+    planeQuery('?enabled=' + (planeToggle.checked ? '1' : '0'));
+  });
+  planeMin.addEventListener('change', function() { planeQuery('?min=' + planeMin.value); });
+  planeMax.addEventListener('change', function() { planeQuery('?max=' + planeMax.value); });
+  planeIntr.addEventListener('change', function() {
+    planeQuery('?intrinsics=' + encodeURIComponent(planeIntr.value));
+  });
+  document.getElementById('planeRefit').addEventListener('click', function() { planeQuery('?refit=1'); });
+  setInterval(function() { if (planeToggle.checked) planeQuery(''); }, 2000);
+  planeQuery('');
+)HTML";
+
+// ---- Shared JS: blob shape controls ----
+inline const std::string kSharedShapeJs = R"HTML(
+  const contoursToggle = document.getElementById('contoursToggle');
+  const contourEps = document.getElementById('contourEps');
+  const contourVerts = document.getElementById('contourVerts');
+  const maxTips = document.getElementById('maxTips');
+  function showContours(d) {
+    contoursToggle.checked = d.enabled;
+    contourEps.value = d.epsilon;
+    document.getElementById('contourEpsVal').textContent = d.epsilon + ' px';
+    contourVerts.value = d.vertices;
+    document.getElementById('contourVertsVal').textContent = d.vertices || 'off';
+    maxTips.value = d.tips;
+    document.getElementById('maxTipsVal').textContent = d.tips;
+  }
+  function contourQuery(q) { fetch('/contours' + q).then(r=>r.json()).then(showContours); }
+  contoursToggle.addEventListener('change', function() {
+    contourQuery('?enabled=' + (contoursToggle.checked ? '1' : '0'));
+  });
+  contourEps.addEventListener('input', function() {
+    document.getElementById('contourEpsVal').textContent = contourEps.value + ' px';
+  });
+  contourEps.addEventListener('change', function() { contourQuery('?epsilon=' + contourEps.value); });
+  contourVerts.addEventListener('input', function() {
+    document.getElementById('contourVertsVal').textContent = contourVerts.value == 0 ? 'off' : contourVerts.value;
+  });
+  contourVerts.addEventListener('change', function() { contourQuery('?vertices=' + contourVerts.value); });
+  maxTips.addEventListener('input', function() {
+    document.getElementById('maxTipsVal').textContent = maxTips.value;
+  });
+  maxTips.addEventListener('change', function() { contourQuery('?tips=' + maxTips.value); });
+  contourQuery('');
+
+  const gesturesToggle = document.getElementById('gesturesToggle');
+  const gestureInputs = {tap: 'gTap', hold: 'gHold', still: 'gStill', speed: 'gSpeed', swipe: 'gSwipe', pinch: 'gPinch'};
+  function showGestures(d) {
+    gesturesToggle.checked = d.enabled;
+    for (const k in gestureInputs) document.getElementById(gestureInputs[k]).value = d[k];
+  }
+  function gestureQuery(q) { fetch('/gestures' + q).then(r=>r.json()).then(showGestures); }
+  gesturesToggle.addEventListener('change', function() {
+    gestureQuery('?enabled=' + (gesturesToggle.checked ? '1' : '0'));
+  });
+  for (const k in gestureInputs) {
+    const el = document.getElementById(gestureInputs[k]);
+    el.addEventListener('change', function() { gestureQuery('?' + k + '=' + el.value); });
+  }
+  function onGesture(e) {
+    const g = JSON.parse(e.data);
+    document.getElementById('gestureInfo').textContent = g.type + (g.dir ? ' ' + g.dir : '') + ' #' + g.id;
+  }
+  gestureQuery('');
+
+  const splitStep = document.getElementById('splitStep');
+  const topK = document.getElementById('topK');
+  const blobRank = document.getElementById('blobRank');
+  const incLabel = document.getElementById('incLabel');
+  const blobAssign = document.getElementById('blobAssign');
+  const confirmFrames = document.getElementById('confirmFrames');
+  const matchGate = document.getElementById('matchGate');
+  const coastFrames = document.getElementById('coastFrames');
+  const deltaPublish = document.getElementById('deltaPublish');
+  const deltaInputs = {deltapx: 'deltaPx', deltamm: 'deltaMm', keyframe: 'keyframeMs'};
+  function showSplit(v) {
+    splitStep.value = v;
+    document.getElementById('splitStepVal').textContent = v > 0 ? v + ' mm' : 'off';
+  }
+  function showTopK(v) {
+    topK.value = v;
+    document.getElementById('topKVal').textContent = v > 0 ? v : 'all';
+  }
+  function showBlobSelect(d) {
+    showSplit(d.split);
+    showTopK(d.topk);
+    blobRank.value = d.rank;
+    incLabel.checked = d.incremental;
+    blobAssign.value = d.assign;
+    confirmFrames.value = d.confirm;
+    coastFrames.value = d.coast;
+    matchGate.value = d.gate;
+    deltaPublish.checked = d.delta;
+    for (const k in deltaInputs) document.getElementById(deltaInputs[k]).value = d[k];
+  }
+  function blobQuery(q) { fetch('/blobdetect' + q).then(r=>r.json()).then(showBlobSelect); }
+  splitStep.addEventListener('input', function() { showSplit(splitStep.value); });
+  splitStep.addEventListener('change', function() { blobQuery('?split=' + splitStep.value); });
+  topK.addEventListener('input', function() { showTopK(topK.value); });
+  topK.addEventListener('change', function() { blobQuery('?topk=' + topK.value); });
+  blobRank.addEventListener('change', function() { blobQuery('?rank=' + blobRank.value); });
+  incLabel.addEventListener('change', function() { blobQuery('?incremental=' + (incLabel.checked ? '1' : '0')); });
+  blobAssign.addEventListener('change', function() { blobQuery('?assign=' + blobAssign.value); });
+  confirmFrames.addEventListener('change', function() { blobQuery('?confirm=' + confirmFrames.value); });
+  coastFrames.addEventListener('change', function() { blobQuery('?coast=' + coastFrames.value); });
+  matchGate.addEventListener('change', function() { blobQuery('?gate=' + matchGate.value); });
+  deltaPublish.addEventListener('change', function() { blobQuery('?delta=' + (deltaPublish.checked ? '1' : '0')); });
+  for (const k in deltaInputs) {
+    const el = document.getElementById(deltaInputs[k]);
+    el.addEventListener('change', function() { blobQuery('?' + k + '=' + el.value); });
+  }
+  blobQuery('');
+)HTML";
+
 // ---- Shared JS: page-load init + FPS polling ----
 inline const std::string kSharedInitJs = R"HTML(
   // Restore sound settings on page load
@@ -560,6 +937,8 @@ inline const std::string kSharedInitJs = R"HTML(
     threshSlider.value = d.threshold;
     threshVal.textContent = d.threshold + ' mm';
     threshSlider.disabled = !d.enabled;
+    weakSlider.value = d.weak;
+    weakVal.textContent = '+' + d.weak + ' mm';
     dilateSlider.value = d.dilate;
     dilateVal.textContent = d.dilate;
   });
@@ -12,6 +12,11 @@
 #include <string>
 #include <vector>
 
+#include "pipeline_settings.hpp"
+#include "bands.hpp"
+#include "roimask.hpp"
+#include "zones.hpp"
+
 // ---- JPEG encoding helpers (stb_image_write.h must already be included) ----
 
 inline void jpegWriteFunc(void* context, void* data, int size) {
@@ -191,3 +196,132 @@ inline void loadSharedSettings(const std::string& text,
     // Note: soundScale_ and soundQuantize_ (strings) are loaded by the caller
     // under its own mutex, since the mutex differs between platforms.
 }
+
+// ---- Pipeline settings (ROI etc.) ----
+
+// Build the pipeline-settings portion of settings.json (no leading/trailing comma).
+inline std::string savePipelineSettingsJson(const PipelineSettings& ps) {
+    return
+        std::string("  \"roiEnabled\": ") + (ps.roiEnabled ? "true" : "false") + ",\n"
+        "  \"roiCrop\": \"" + ps.roiCrop + "\",\n"
+        "  \"roiExclude\": \"" + ps.roiExclude + "\",\n"
+        "  \"hysteresisMm\": " + std::to_string(ps.hysteresisMm) + ",\n"
+        "  \"planeEnabled\": " + (ps.planeEnabled ? "true" : "false") + ",\n"
+        "  \"planeMinMm\": " + std::to_string(ps.planeMinMm) + ",\n"
+        "  \"planeMaxMm\": " + std::to_string(ps.planeMaxMm) + ",\n"
+        "  \"intrinsics\": \"" + ps.intrinsics + "\",\n"
+        "  \"bandsEnabled\": " + (ps.bandsEnabled ? "true" : "false") + ",\n"
+        "  \"bands\": \"" + ps.bands + "\",\n"
+        "  \"splitStepMm\": " + std::to_string(ps.splitStepMm) + ",\n"
+        "  \"maxBlobs\": " + std::to_string(ps.maxBlobs) + ",\n"
+        "  \"nearestFirst\": " + (ps.nearestFirst ? "true" : "false") + ",\n"
+        "  \"incrementalLabeling\": " + (ps.incrementalLabeling ? "true" : "false") + ",\n"
+        "  \"optimalAssignment\": " + (ps.optimalAssignment ? "true" : "false") + ",\n"
+        "  \"confirmFrames\": " + std::to_string(ps.confirmFrames) + ",\n"
+        "  \"coastFrames\": " + std::to_string(ps.coastFrames) + ",\n"
+        "  \"matchGateMm\": " + std::to_string(ps.matchGateMm) + ",\n"
+        "  \"deltaPublish\": " + (ps.deltaPublish ? "true" : "false") + ",\n"
+        "  \"deltaPx\": " + std::to_string(ps.deltaPx) + ",\n"
+        "  \"deltaMm\": " + std::to_string(ps.deltaMm) + ",\n"
+        "  \"keyframeMs\": " + std::to_string(ps.keyframeMs) + ",\n"
+        "  \"gesturesEnabled\": " + (ps.gesturesEnabled ? "true" : "false") + ",\n"
+        "  \"tapMaxMs\": " + std::to_string(ps.tapMaxMs) + ",\n"
+        "  \"holdMs\": " + std::to_string(ps.holdMs) + ",\n"
+        "  \"stillRadiusPx\": " + std::to_string(ps.stillRadiusPx) + ",\n"
+        "  \"swipeSpeed\": " + std::to_string(ps.swipeSpeed) + ",\n"
+        "  \"swipeMinPx\": " + std::to_string(ps.swipeMinPx) + ",\n"
+        "  \"pinchStepPct\": " + std::to_string(ps.pinchStepPct) + ",\n"
+        "  \"contoursEnabled\": " + (ps.contoursEnabled ? "true" : "false") + ",\n"
+        "  \"contourEpsilonPx\": " + std::to_string(ps.contourEpsilonPx) + ",\n"
+        "  \"contourMaxVertices\": " + std::to_string(ps.contourMaxVertices) + ",\n"
+        "  \"maxTips\": " + std::to_string(ps.maxTips) + ",\n"
+        "  \"zonesEnabled\": " + (ps.zonesEnabled ? "true" : "false") + ",\n"
+        "  \"zones\": \"" + ps.zones + "\"";
+}
+
+// Parse the pipeline-settings portion of settings.json.
+inline void loadPipelineSettings(const std::string& text, PipelineSettings& ps) {
+    int iv; bool bv; std::string sv;
+    if (jsonBool(text, "roiEnabled", bv)) ps.roiEnabled = bv;
+    if (jsonString(text, "roiCrop", sv)) ps.roiCrop = sanitizeRoiSpec(sv);
+    if (jsonString(text, "roiExclude", sv)) ps.roiExclude = sanitizeRoiSpec(sv);
+    if (jsonInt(text, "hysteresisMm", iv)) ps.hysteresisMm = iv;
+    if (jsonBool(text, "planeEnabled", bv)) ps.planeEnabled = bv;
+    if (jsonInt(text, "planeMinMm", iv)) ps.planeMinMm = iv;
+    if (jsonInt(text, "planeMaxMm", iv)) ps.planeMaxMm = iv;
+    if (jsonString(text, "intrinsics", sv)) ps.intrinsics = sanitizeRoiSpec(sv);
+    if (jsonBool(text, "bandsEnabled", bv)) ps.bandsEnabled = bv;
+    if (jsonString(text, "bands", sv)) ps.bands = sanitizeBandSpec(sv);
+    if (jsonInt(text, "splitStepMm", iv)) ps.splitStepMm = iv;
+    if (jsonInt(text, "maxBlobs", iv)) ps.maxBlobs = iv;
+    if (jsonBool(text, "nearestFirst", bv)) ps.nearestFirst = bv;
+    if (jsonBool(text, "incrementalLabeling", bv)) ps.incrementalLabeling = bv;
+    if (jsonBool(text, "optimalAssignment", bv)) ps.optimalAssignment = bv;
+    if (jsonInt(text, "confirmFrames", iv)) ps.confirmFrames = iv;
+    if (jsonInt(text, "coastFrames", iv)) ps.coastFrames = iv;
+    if (jsonInt(text, "matchGateMm", iv)) ps.matchGateMm = iv;
+    if (jsonBool(text, "deltaPublish", bv)) ps.deltaPublish = bv;
+    if (jsonInt(text, "deltaPx", iv)) ps.deltaPx = iv;
+    if (jsonInt(text, "deltaMm", iv)) ps.deltaMm = iv;
+    if (jsonInt(text, "keyframeMs", iv)) ps.keyframeMs = iv;
+    if (jsonBool(text, "gesturesEnabled", bv)) ps.gesturesEnabled = bv;
+    if (jsonInt(text, "tapMaxMs", iv)) ps.tapMaxMs = iv;
+    if (jsonInt(text, "holdMs", iv)) ps.holdMs = iv;
+    if (jsonInt(text, "stillRadiusPx", iv)) ps.stillRadiusPx = iv;
+    if (jsonInt(text, "swipeSpeed", iv)) ps.swipeSpeed = iv;
+    if (jsonInt(text, "swipeMinPx", iv)) ps.swipeMinPx = iv;
+    if (jsonInt(text, "pinchStepPct", iv)) ps.pinchStepPct = iv;
+    if (jsonBool(text, "contoursEnabled", bv)) ps.contoursEnabled = bv;
+    if (jsonInt(text, "contourEpsilonPx", iv)) ps.contourEpsilonPx = iv;
+    if (jsonInt(text, "contourMaxVertices", iv)) ps.contourMaxVertices = iv;
+    if (jsonInt(text, "maxTips", iv)) ps.maxTips = iv;
+    if (jsonBool(text, "zonesEnabled", bv)) ps.zonesEnabled = bv;
+    if (jsonString(text, "zones", sv)) ps.zones = sanitizeZoneSpec(sv);
+}
+
+// JSON body for GET /roi.
+inline std::string roiSettingsJson(const PipelineSettings& ps) {
+    return std::string("{\"enabled\":") + (ps.roiEnabled ? "true" : "false") +
+           ",\"crop\":\"" + ps.roiCrop + "\"" +
+           ",\"exclude\":\"" + ps.roiExclude + "\"}";
+}
+
+// JSON body for GET /zones.
+inline std::string zoneSettingsJson(const PipelineSettings& ps) {
+    return std::string("{\"enabled\":") + (ps.zonesEnabled ? "true" : "false") +
+           ",\"spec\":\"" + ps.zones + "\"}";
+}
+
+// JSON body for GET /bands.
+inline std::string bandSettingsJson(const PipelineSettings& ps) {
+    return std::string("{\"enabled\":") + (ps.bandsEnabled ? "true" : "false") +
+           ",\"spec\":\"" + ps.bands + "\"}";
+}
+
+// JSON body for GET /contours (outline and extremity settings).
+inline std::string contourSettingsJson(const PipelineSettings& ps) {
+    return std::string("{\"enabled\":") + (ps.contoursEnabled ? "true" : "false") +
+           ",\"epsilon\":" + std::to_string(ps.contourEpsilonPx) +
+           ",\"vertices\":" + std::to_string(ps.contourMaxVertices) +
+           ",\"tips\":" + std::to_string(ps.maxTips) + "}";
+}
+
+// JSON body for GET /gestures (recognizer settings).
+inline std::string gestureSettingsJson(const PipelineSettings& ps) {
+    return std::string("{\"enabled\":") + (ps.gesturesEnabled ? "true" : "false") +
+           ",\"tap\":" + std::to_string(ps.tapMaxMs) +
+           ",\"hold\":" + std::to_string(ps.holdMs) +
+           ",\"still\":" + std::to_string(ps.stillRadiusPx) +
+           ",\"speed\":" + std::to_string(ps.swipeSpeed) +
+           ",\"swipe\":" + std::to_string(ps.swipeMinPx) +
+           ",\"pinch\":" + std::to_string(ps.pinchStepPct) + "}";
+}
+
+// JSON body for GET /plane: settings plus the latest fit status from the frame loop.
+inline std::string planeSettingsJson(const PipelineSettings& ps, const std::string& status) {
+    return std::string("{\"enabled\":") + (ps.planeEnabled ? "true" : "false") +
+           ",\"min\":" + std::to_string(ps.planeMinMm) +
+           ",\"max\":" + std::to_string(ps.planeMaxMm) +
+           ",\"intrinsics\":\"" + ps.intrinsics + "\"" +
+           ",\"plane\":" + status + "}";
+}
@@ -0,0 +1,201 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "blobdetect.hpp"
+#include "depthcolor.hpp"
+#include "roimask.hpp"
+
+// Multi-zone segmentation: the frame is split into up to kMaxZones-1 polygonal
+// zones, each with its own near/far depth band. Pixels outside every zone
+// (zone 0) use the global threshold. The zone map is compiled once per config
+// change; the per-frame threshold pass looks up each pixel's band and
+// accumulates per-zone occupancy in the same loop.
+//
+// Spec format (normalized coordinates, zones separated by ';'):
+//   "near-far: x,y x,y x,y; near-far: x,y x,y x,y x,y"
+// e.g. "400-700: 0,0 0.5,0 0.5,1 0,1; 300-550: 0.5,0 1,0 1,1 0.5,1"
+// Zones are numbered 1..N in spec order; where zones overlap the later one wins.
+
+constexpr int kMaxZones = 16;   // zone ids 1..15, 0 = outside every zone
+
+struct ZoneDef {
+    uint16_t nearMm = 1;
+    uint16_t farMm = 65535;
+    std::vector<RoiPoint> poly;
+};
+
+struct ZoneMap {
+    int width = 0;
+    int height = 0;
+    int count = 0;                       // configured zones (ids 1..count)
+    std::vector<uint8_t> map;            // per-pixel zone id
+    uint16_t nearMm[kMaxZones] = {};     // per-zone band [near, far)
+    uint16_t farMm[kMaxZones] = {};
+};
+
+struct ZoneOccupancy {
+    int pixelCount[kMaxZones];           // foreground pixels in zone
+    int blobCount[kMaxZones];            // kept blobs whose pixels lie in zone
+    uint16_t nearestMm[kMaxZones];       // closest foreground depth (0 = empty)
+
+    void clear() {
+        std::memset(pixelCount, 0, sizeof(pixelCount));
+        std::memset(blobCount, 0, sizeof(blobCount));
+        std::memset(nearestMm, 0, sizeof(nearestMm));
+    }
+};
+
+// Keep only characters valid in a zone spec (ROI spec characters plus ':').
+inline std::string sanitizeZoneSpec(const std::string& text) {
+    std::string out;
+    out.reserve(text.size());
+    for (char c : text) {
+        if ((c >= '0' && c <= '9') || c == '.' || c == ',' || c == ';' || c == ' ' ||
+            c == '-' || c == ':')
+            out += c;
+    }
+    return out;
+}
+
+// Parse a zone spec. Zones with a malformed band or fewer than 3 vertices
+// are dropped; at most kMaxZones-1 zones are kept.
+inline std::vector<ZoneDef> parseZoneSpec(const std::string& text) {
+    std::vector<ZoneDef> zones;
+    size_t pos = 0;
+    while (pos < text.size() && static_cast<int>(zones.size()) < kMaxZones - 1) {
+        size_t end = text.find(';', pos);
+        if (end == std::string::npos) end = text.size();
+        std::string item = text.substr(pos, end - pos);
+        pos = end + 1;
+
+        size_t colon = item.find(':');
+        if (colon == std::string::npos) continue;
+        const char* p = item.c_str();
+        char* e = nullptr;
+        long nearMm = std::strtol(p, &e, 10);
+        if (e == p) continue;
+        while (*e == ' ') e++;
+        if (*e != '-') continue;
+        const char* q = e + 1;
+        long farMm = std::strtol(q, &e, 10);
+        if (e == q) continue;
+
+        auto polys = parseRoiPolygons(item.substr(colon + 1));
+        if (polys.empty()) continue;
+
+        ZoneDef z;
+        z.nearMm = static_cast<uint16_t>(std::min(65535L, std::max(1L, nearMm)));
+        z.farMm = static_cast<uint16_t>(std::min(65535L, std::max(1L, farMm)));
+        if (z.farMm < z.nearMm) std::swap(z.nearMm, z.farMm);
+        z.poly = std::move(polys[0]);
+        zones.push_back(std::move(z));
+    }
+    return zones;
+}
+
+// Rasterize the zone spec into a per-pixel zone id map.
+// count == 0 (disabled or empty spec) means kernels should skip zone handling.
+inline void compileZoneMap(ZoneMap& zm, int width, int height, bool enabled,
+                           const std::string& spec) {
+    zm.width = width;
+    zm.height = height;
+    zm.map.assign(static_cast<size_t>(width) * height, 0);
+    std::fill(std::begin(zm.nearMm), std::end(zm.nearMm), uint16_t(1));
+    std::fill(std::begin(zm.farMm), std::end(zm.farMm), uint16_t(65535));
+
+    auto zones = enabled ? parseZoneSpec(spec) : std::vector<ZoneDef>{};
+    zm.count = static_cast<int>(zones.size());
+
+    std::vector<float> xs;
+    std::vector<Span> runs;
+    for (int z = 0; z < zm.count; z++) {
+        uint8_t id = static_cast<uint8_t>(z + 1);
+        zm.nearMm[id] = zones[z].nearMm;
+        zm.farMm[id] = zones[z].farMm;
+        for (int y = 0; y < height; y++) {
+            runs.clear();
+            appendPolygonRowRuns(zones[z].poly, (y + 0.5f) / height, width, xs, runs);
+            uint8_t* row = zm.map.data() + static_cast<size_t>(y) * width;
+            for (const auto& r : runs) std::memset(row + r.x0, id, r.x1 - r.x0);
+        }
+    }
+}
+
+// Threshold depth to black/white using each pixel's zone band, in one pass.
+// Zone 0 (outside every zone) uses [1, thresholdMm) like depthToThresholdBgr.
+// Foreground pixel counts and nearest depth per zone are accumulated into occ
+// (cleared first); blob counts are filled later by countZoneBlobs.
+// With hysteresisMm > 0 each band's far edge gets a weak margin, as in
+// depthToThresholdBgr; only strong pixels count towards occupancy.
+// If roi is given (and not full-frame), only the active spans are visited.
+inline void depthToZoneThresholdBgr(const uint16_t* depthMm, int width, int height,
+                                    uint8_t* outBgr, uint16_t thresholdMm,
+                                    const ZoneMap& zones, ZoneOccupancy& occ,
+                                    const RoiSpans* roi = nullptr,
+                                    uint16_t hysteresisMm = 0) {
+    uint16_t lo[kMaxZones], hi[kMaxZones], weak[kMaxZones];
+    std::memcpy(lo, zones.nearMm, sizeof(lo));
+    std::memcpy(hi, zones.farMm, sizeof(hi));
+    lo[0] = 1;
+    hi[0] = thresholdMm;
+    for (int z = 0; z < kMaxZones; z++)
+        weak[z] = static_cast<uint16_t>(std::min(65535, hi[z] + hysteresisMm));
+    occ.clear();
+
+    const uint8_t* zmap = zones.map.data();
+    auto thresholdPixel = [&](int i) {
+        uint16_t d = depthMm[i];
+        uint8_t z = zmap[i];
+        bool fg = d >= lo[z] && d < hi[z];
+        uint8_t v = fg ? 0 : (d >= lo[z] && d < weak[z]) ? kWeakForeground : 255;
+        outBgr[i * 3 + 0] = v;
+        outBgr[i * 3 + 1] = v;
+        outBgr[i * 3 + 2] = v;
+        if (fg) {
+            occ.pixelCount[z]++;
+            if (occ.nearestMm[z] == 0 || d < occ.nearestMm[z]) occ.nearestMm[z] = d;
+        }
+    };
+
+    if (!roi || roi->full) {
+        int total = width * height;
+        for (int i = 0; i < total; i++) thresholdPixel(i);
+        return;
+    }
+
+    std::memset(outBgr, 255, static_cast<size_t>(width) * height * 3);
+    for (int y = 0; y < height; y++) {
+        for (int s = roi->rowBegin(y); s < roi->rowEnd(y); s++) {
+            const Span& sp = roi->spans[s];
+            for (int i = y * width + sp.x0; i < y * width + sp.x1; i++) thresholdPixel(i);
+        }
+    }
+}
+
+// Count kept blobs per zone (blobs are labeled within a single zone).
+inline void countZoneBlobs(ZoneOccupancy& occ, const std::vector<BlobInfo>& blobs) {
+    for (const auto& b : blobs) occ.blobCount[b.zone]++;
+}
+
+// JSON array of per-zone occupancy for zones 1..count, e.g.
+// [{"id":1,"near":400,"far":700,"px":812,"blobs":1,"nearest":455}]
+inline std::string zoneOccupancyJson(const ZoneMap& zones, const ZoneOccupancy& occ) {
+    std::string json = "[";
+    for (int z = 1; z <= zones.count; z++) {
+        if (z > 1) json += ",";
+        json += "{\"id\":" + std::to_string(z) +
+                ",\"near\":" + std::to_string(zones.nearMm[z]) +
+                ",\"far\":" + std::to_string(zones.farMm[z]) +
+                ",\"px\":" + std::to_string(occ.pixelCount[z]) +
+                ",\"blobs\":" + std::to_string(occ.blobCount[z]) +
+                ",\"nearest\":" + std::to_string(occ.nearestMm[z]) + "}";
+    }
+    json += "]";
+    return json;
+}
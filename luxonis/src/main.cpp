@@ -1,6 +1,6 @@
 #include <atomic>
 #include <chrono>
-#include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <iostream>
 #include <string>
@@ -9,9 +9,20 @@
 
 #include <depthai/depthai.hpp>
 
+#include "bands.hpp"
 #include "blobdetect.hpp"
+#include "blobjson.hpp"
+#include "blobpublish.hpp"
+#include "blobshape.hpp"
 #include "blobtracker.hpp"
+#include "deproject.hpp"
 #include "depthcolor.hpp"
+#include "eventlog.hpp"
+#include "intrinsics.hpp"
+#include "plane.hpp"
+#include "registration.hpp"
+#include "tilelabel.hpp"
+#include "zones.hpp"
 #ifdef VIEWER_LINUX
 #include "viewer_linux.hpp"
 #else
@@ -35,6 +46,9 @@ static std::atomic<bool> g_restartRequested{false};
 static std::atomic<int> g_monoResolution{2};   // 0=720P, 1=800P, 2=400P, 3=480P
 static std::atomic<int> g_cameraFps{30};
 
+// Nominal mono camera HFOV, used only when the device calibration can't be read
+static constexpr float kDepthHfovDeg = 72.0f;
+
 static dai::MonoCameraProperties::SensorResolution resolutionFromInt(int val) {
     switch (val) {
         case 0: return dai::MonoCameraProperties::SensorResolution::THE_720_P;
@@ -167,6 +181,10 @@ int main(int argc, char* argv[]) {
     bool showWindow = false;
     bool showColor = false;
     bool showWeb = true;
+    std::string registrationFile;   // depth->color calibration, overrides the device's
+    LogLevel logLevel = LogLevel::Info;   // cursor moves and frame ticks are debug
+    int logRate = 100;                    // text lines per second, 0 = unlimited
+    std::string eventLogFile;             // binary copy of every log record
     for (int i = 1; i < argc; i++) {
         if (std::strcmp(argv[i], "--window") == 0 || std::strcmp(argv[i], "-w") == 0) {
             showWindow = true;
@@ -176,8 +194,18 @@ int main(int argc, char* argv[]) {
             showWeb = false;
         } else if (std::strcmp(argv[i], "--no-blob") == 0) {
             g_blobDetectEnabled.store(false);
+        } else if (std::strcmp(argv[i], "--registration") == 0 && i + 1 < argc) {
+            registrationFile = argv[++i];
+        } else if (std::strcmp(argv[i], "--log-level") == 0 && i + 1 < argc) {
+            if (!parseLogLevel(argv[++i], logLevel))
+                std::cerr << "Unknown log level " << argv[i] << " (debug, info, warn, off)" << std::endl;
+        } else if (std::strcmp(argv[i], "--log-rate") == 0 && i + 1 < argc) {
+            logRate = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--event-log") == 0 && i + 1 < argc) {
+            eventLogFile = argv[++i];
         }
     }
+    eventLog().start(logLevel, logRate, eventLogFile);
 
     // Optional Win32 viewer window
     ImageViewer viewer;
@@ -192,6 +220,7 @@ int main(int argc, char* argv[]) {
     if (showWeb) webServer.start();
 
     auto programStart = std::chrono::steady_clock::now();
+    TrackerCheckpoint checkpoint;   // tracker state carried across pipeline restarts
 
     // Outer loop: recreate pipeline when preset changes require restart
     while (true) {
@@ -241,6 +270,22 @@ int main(int argc, char* argv[]) {
         int depthH = firstDepth->getHeight();
         std::cout << "Depth: " << depthW << "x" << depthH << std::endl;
 
+        // Depth intrinsics from the device calibration (plane fitting, metric blob positions).
+        // Stereo depth is aligned to the rectified right camera by default.
+        CameraIntrinsics deviceIntr;
+        try {
+            auto m = device.readCalibration().getCameraIntrinsics(
+                dai::CameraBoardSocket::CAM_C, depthW, depthH);
+            if (m.size() >= 2 && m[0].size() >= 3 && m[1].size() >= 3) {
+                deviceIntr.width = depthW;
+                deviceIntr.height = depthH;
+                deviceIntr.fx = m[0][0];
+                deviceIntr.fy = m[1][1];
+                deviceIntr.cx = m[0][2];
+                deviceIntr.cy = m[1][2];
+            }
+        } catch (...) {}
+
         // Color stream (optional)
         int colorW = 0, colorH = 0;
         std::shared_ptr<dai::ImgFrame> firstColor;
@@ -253,6 +298,39 @@ int main(int argc, char* argv[]) {
             std::cout << "Color: " << colorW << "x" << colorH << std::endl;
         }
 
+        // Color intrinsics and depth->color transform (registration). Depth is in
+        // the rectified right frame, so the right rectification is undone first.
+        CameraIntrinsics colorIntr;
+        CameraExtrinsics colorExt;
+        if (colorW > 0) {
+            try {
+                auto calib = device.readCalibration();
+                auto m = calib.getCameraIntrinsics(dai::CameraBoardSocket::CAM_A, colorW, colorH);
+                auto e = calib.getCameraExtrinsics(dai::CameraBoardSocket::CAM_C,
+                                                   dai::CameraBoardSocket::CAM_A);
+                auto rect = calib.getStereoRightRectificationRotation();
+                if (m.size() >= 2 && m[0].size() >= 3 && m[1].size() >= 3 && e.size() >= 3 &&
+                    rect.size() >= 3) {
+                    colorIntr.width = colorW;
+                    colorIntr.height = colorH;
+                    colorIntr.fx = m[0][0];
+                    colorIntr.fy = m[1][1];
+                    colorIntr.cx = m[0][2];
+                    colorIntr.cy = m[1][2];
+                    for (int r = 0; r < 3; r++) {
+                        for (int c = 0; c < 3; c++) {
+                            float v = 0.0f;   // (E_rot * rect^T)[r][c]
+                            for (int k = 0; k < 3; k++) v += e[r][k] * rect[c][k];
+                            colorExt.r[r * 3 + c] = v;
+                        }
+                        colorExt.t[r] = e[r][3] * 10.0f;   // cm -> mm
+                    }
+                }
+            } catch (...) {}
+            if (!registrationFile.empty() && !loadRegistrationFile(registrationFile, colorIntr, colorExt))
+                std::cerr << "Warning: could not read registration file " << registrationFile << std::endl;
+        }
+
         if (showWindow && !viewer.isInitialized()) {
             int windowW = showColor ? colorW + depthW : depthW;
             int windowH = showColor ? std::max(colorH, depthH) : depthH;
@@ -268,6 +346,125 @@ int main(int argc, char* argv[]) {
         if (showColor) colorBgr.resize(colorW * colorH * 3);
         std::vector<uint8_t> depthBgr(depthW * depthH * 3);
 
+        // Region of interest spans and zone map — recompiled only when the web UI changes them
+        RoiSpans roi;
+        ZoneMap zones;
+        ZoneOccupancy zoneOcc;
+        zoneOcc.clear();
+        uint16_t hysteresisMm = 0;
+        PlaneEstimator plane;
+        bool planeEnabled = false;
+        DepthBands bands;
+        std::string bandSpec = "-";
+        std::vector<uint8_t> bandMap(depthW * depthH);
+        BlobTracker tracker;
+        std::vector<BlobTracker> bandTrackers;    // one id space per depth band
+        BlobPublishFilter publishFilter;          // skips frames where nothing moved
+        bool zonesUsed = false;                   // segmentation used for the current frame
+        bool bandsUsed = false;
+        std::vector<int> blobLabels(depthW * depthH);   // label image for the shape stage
+        BlobShapeAnalyzer shape;
+        int splitStepMm = 0;
+        int maxBlobs = 0;
+        bool nearestFirst = false;
+        IncrementalLabeler tileLabeler;
+        bool incrementalLabeling = false;
+        DepthRays rays;                           // pixel -> camera-space mm
+        DepthColorRegistration registration;      // color mode only (see below)
+        std::vector<uint8_t> colorInDepth(colorW > 0 ? depthW * depthH * 3 : 0);   // registered color
+        std::vector<uint8_t> colorView(colorInDepth.size());   // registered color + blob boxes, for the window
+        std::vector<uint8_t> cloudMask(depthW * depthH);   // foreground for /pointcloud
+        int pipelineSeq = -1;
+        auto refreshPipelineSettings = [&]() {
+            int seq = webServer.pipelineSettingsSeq();
+            if (seq == pipelineSeq) return;
+            pipelineSeq = seq;
+            auto ps = webServer.getPipelineSettings();
+            compileRoiSpans(roi, depthW, depthH, ps.roiEnabled, ps.roiCrop, ps.roiExclude);
+            compileZoneMap(zones, depthW, depthH, ps.zonesEnabled, ps.zones);
+            hysteresisMm = static_cast<uint16_t>(ps.hysteresisMm);
+            planeEnabled = ps.planeEnabled;
+            CameraIntrinsics intr = resolveIntrinsics(ps.intrinsics, deviceIntr, depthW, depthH,
+                                                      kDepthHfovDeg);
+            plane.configure(intr, ps.planeMinMm, ps.planeMaxMm);
+            rays.configure(intr);
+            if (colorW > 0) registration.configure(intr, scaleIntrinsics(colorIntr, colorW, colorH), colorExt);
+            webServer.updatePlaneStatus(plane.json());
+            splitStepMm = ps.splitStepMm;
+            maxBlobs = ps.maxBlobs;
+            nearestFirst = ps.nearestFirst;
+            incrementalLabeling = ps.incrementalLabeling;
+            tileLabeler.reset();
+            shape.configure(ps.contoursEnabled ? static_cast<float>(ps.contourEpsilonPx) : 0.0f,
+                            ps.contourMaxVertices, ps.maxTips);
+            std::string spec = ps.bandsEnabled ? ps.bands : std::string();
+            if (spec != bandSpec) {
+                bandSpec = spec;
+                compileDepthBands(bands, ps.bandsEnabled, spec);
+                bandTrackers.assign(bands.count, BlobTracker());
+            }
+            tracker.setOptimalAssignment(ps.optimalAssignment);
+            for (auto& t : bandTrackers) t.setOptimalAssignment(ps.optimalAssignment);
+            tracker.setLifecycle(ps.confirmFrames, ps.coastFrames);
+            for (auto& t : bandTrackers) t.setLifecycle(ps.confirmFrames, ps.coastFrames);
+            tracker.setMatchGate(static_cast<float>(ps.matchGateMm), intr.fx, intr.width);
+            for (auto& t : bandTrackers) t.setMatchGate(static_cast<float>(ps.matchGateMm), intr.fx, intr.width);
+            GestureSettings gestures;
+            gestures.enabled = ps.gesturesEnabled;
+            gestures.tapMaxMs = ps.tapMaxMs;
+            gestures.holdMs = ps.holdMs;
+            gestures.stillRadiusPx = static_cast<float>(ps.stillRadiusPx);
+            gestures.swipeSpeed = static_cast<float>(ps.swipeSpeed);
+            gestures.swipeMinPx = static_cast<float>(ps.swipeMinPx);
+            gestures.pinchStep = ps.pinchStepPct / 100.0f;
+            tracker.setGestures(gestures);
+            for (auto& t : bandTrackers) t.setGestures(gestures);
+            publishFilter.configure(ps.deltaPublish, ps.deltaPx, ps.deltaMm, ps.keyframeMs);
+        };
+        refreshPipelineSettings();
+
+        // Pick up the tracks of the previous run so hands keep their ids
+        // (band trackers only if the bands are unchanged)
+        if (checkpoint.width > 0) {
+            float sx = static_cast<float>(depthW) / checkpoint.width;
+            float sy = static_cast<float>(depthH) / checkpoint.height;
+            tracker.restoreState(checkpoint.single, sx, sy, checkpoint.ms);
+            if (checkpoint.bands == bandSpec && checkpoint.bandStates.size() == bandTrackers.size())
+                for (size_t i = 0; i < bandTrackers.size(); i++)
+                    bandTrackers[i].restoreState(checkpoint.bandStates[i], sx, sy, checkpoint.ms);
+        }
+
+        // Threshold pass, first match wins: height above the fitted surface when the
+        // plane is enabled, depth bands, per-zone bands (with occupancy), global threshold.
+        // With hysteresis the weak band is written gray and resolved while labeling
+        // (not in band mode, where bands may be adjacent), so only while blobs are detected.
+        auto thresholdDepth = [&](const uint16_t* depth, uint16_t thr) {
+            uint16_t hyst = g_blobDetectEnabled.load() ? hysteresisMm : 0;
+            if (planeEnabled) {
+                if (webServer.takePlaneRefitRequest()) plane.requestRefit();
+                if (plane.update(depth)) webServer.updatePlaneStatus(plane.json());
+            }
+            zonesUsed = false;
+            bandsUsed = false;
+            if (planeEnabled && plane.active()) {
+                depthToPlaneThresholdBgr(depth, depthW, depthH, depthBgr.data(),
+                                         plane.nearLimit(), plane.farLimit(), &roi, hyst);
+            } else if (bands.count > 0) {
+                depthToBandsBgr(depth, depthW, depthH, depthBgr.data(), bands, bandMap.data(), &roi);
+                bandsUsed = true;
+            } else if (zones.count > 0) {
+                depthToZoneThresholdBgr(depth, depthW, depthH, depthBgr.data(), thr,
+                                        zones, zoneOcc, &roi, hyst);
+                zonesUsed = true;
+            } else {
+                depthToThresholdBgr(depth, depthW, depthH, depthBgr.data(), thr, &roi, hyst);
+            }
+        };
+        auto zoneIds = [&]() -> const uint8_t* { return zonesUsed ? zones.map.data() : nullptr; };
+        auto bandIds = [&]() -> const uint8_t* { return bandsUsed ? bandMap.data() : nullptr; };
+        // Dilation would merge pixels across band boundaries, so band mode skips it
+        auto dilateIterations = [&]() { return bandsUsed ? 0 : g_dilateIterations.load(); };
+
         // Process first frames
         {
             if (showColor) {
@@ -281,17 +478,22 @@ int main(int argc, char* argv[]) {
             {
                 uint16_t thr = g_thresholdEnabled.load()
                     ? static_cast<uint16_t>(g_thresholdMm.load()) : uint16_t(65535);
-                depthToThresholdBgr(depthPixels, depthW, depthH, depthBgr.data(), thr);
+                thresholdDepth(depthPixels, thr);
             }
-            dilateBinaryBgr(depthBgr.data(), depthW, depthH, g_dilateIterations.load());
+            dilateBinaryBgr(depthBgr.data(), depthW, depthH, dilateIterations(), &roi);
 
             if (g_blobDetectEnabled.load())
                 detectAndDrawBlobs(depthBgr.data(), depthW, depthH,
                                    g_maxBlobPixels.load(), depthPixels,
-                                   g_minBlobPixels.load());
+                                   g_minBlobPixels.load(), &roi, zoneIds(), bandIds());
 
             if (showWindow) {
-                if (showColor)
+                // Registered color (aligned with the mask, blob boxes drawn on
+                // it) when there is a calibration, else the raw color frame
+                if (registration.ready())
+                    viewer.updateSideBySide(colorView.data(), depthW, depthH,
+                                            depthBgr.data(), depthW, depthH);
+                else if (showColor)
                     viewer.updateSideBySide(colorBgr.data(), colorW, colorH,
                                             depthBgr.data(), depthW, depthH);
                 else
@@ -316,7 +518,62 @@ int main(int argc, char* argv[]) {
             return true;
         };
 
-        BlobTracker tracker;
+        // Track blobs (one tracker per depth band in band mode) and publish them
+        std::vector<std::vector<BlobInfo>> bandBlobs(kMaxBands + 1);
+        std::vector<BlobLayer> layers;
+        TrackHistorySnapshot trackHistory;   // for /tracks, reused across frames
+        auto saveCheckpoint = [&](long long ms) {
+            checkpoint.ms = ms;
+            checkpoint.width = depthW;
+            checkpoint.height = depthH;
+            checkpoint.bands = bandSpec;
+            tracker.saveState(checkpoint.single);
+            checkpoint.bandStates.resize(bandTrackers.size());
+            for (size_t i = 0; i < bandTrackers.size(); i++) bandTrackers[i].saveState(checkpoint.bandStates[i]);
+            if (showWeb && webServer.checkpointWanted()) webServer.updateCheckpoint(checkpoint);
+        };
+        auto trackAndPublish = [&](std::vector<BlobInfo>&& blobs, int frame, long long ms) {
+            if (!bandsUsed) {
+                tracker.update(std::move(blobs), frame, ms);
+                for (auto& t : bandTrackers) t.update({}, frame, ms);
+                if (showWeb) {
+                    const ZoneMap* zm = zonesUsed ? &zones : nullptr;
+                    webServer.pushGestures(tracker.gestureEvents());
+                    if (publishFilter.due(ms, tracker.activeBlobs(), nullptr, zm, &zoneOcc))
+                        webServer.updateBlobs(blobsJson(depthW, depthH, tracker.activeBlobs(), zm, &zoneOcc),
+                                              blobsBinary(depthW, depthH, tracker.activeBlobs()));
+                    if (webServer.tracksWanted()) {
+                        trackHistory.clear(ms);
+                        tracker.snapshotHistory(0, trackHistory);
+                        webServer.updateTracks(trackHistory);
+                    }
+                }
+                saveCheckpoint(ms);
+                return;
+            }
+            tracker.update({}, frame, ms);
+            for (auto& v : bandBlobs) v.clear();
+            for (auto& b : blobs) bandBlobs[b.band].push_back(std::move(b));
+            layers.clear();
+            for (int i = 0; i < bands.count; i++) {
+                bandTrackers[i].update(std::move(bandBlobs[i + 1]), frame, ms);
+                layers.push_back({i + 1, bands.nearMm[i + 1], bands.farMm[i + 1],
+                                  &bandTrackers[i].activeBlobs()});
+            }
+            if (showWeb) {
+                for (int i = 0; i < bands.count; i++) webServer.pushGestures(bandTrackers[i].gestureEvents());
+                const auto& primary = bandTrackers[0].activeBlobs();
+                if (publishFilter.due(ms, primary, &layers))
+                    webServer.updateBlobs(blobsJson(depthW, depthH, primary, nullptr, nullptr, &layers),
+                                          blobsBinary(depthW, depthH, primary, &layers));
+                if (webServer.tracksWanted()) {
+                    trackHistory.clear(ms);
+                    for (int i = 0; i < bands.count; i++) bandTrackers[i].snapshotHistory(i + 1, trackHistory);
+                    webServer.updateTracks(trackHistory);
+                }
+            }
+            saveCheckpoint(ms);
+        };
         int frameCount = 0;
         int fpsFrames = 0;
         auto fpsStart = std::chrono::steady_clock::now();
@@ -325,6 +582,7 @@ int main(int argc, char* argv[]) {
             // Grab whatever is available — only reprocess streams that actually updated
             bool gotNewDepth = false;
             bool gotNewColor = false;
+            bool cloudWanted = false;
             if (auto f = depthQueue->tryGet<dai::ImgFrame>()) { latestDepth = f; gotNewDepth = true; }
             if (showColor) {
                 if (auto f = colorQueue->tryGet<dai::ImgFrame>()) { latestColor = f; gotNewColor = true; }
@@ -344,14 +602,25 @@ int main(int argc, char* argv[]) {
 
             // Only reprocess depth when the depth frame actually changed
             if (gotNewDepth) {
+                refreshPipelineSettings();
                 const auto& depthData = latestDepth->getData();
                 const auto* depthPixels = reinterpret_cast<const uint16_t*>(depthData.data());
+
+                // Color mode: the latest color seen by every depth pixel, for the
+                // window, the blob colors and /pointcloud
+                if (registration.ready()) {
+                    registration.colorInDepth(depthPixels, colorBgr.data(), colorInDepth.data());
+                    if (showWindow) colorView = colorInDepth;
+                }
                 {
                     uint16_t thr = g_thresholdEnabled.load()
                         ? static_cast<uint16_t>(g_thresholdMm.load()) : uint16_t(65535);
-                    depthToThresholdBgr(depthPixels, depthW, depthH, depthBgr.data(), thr);
+                    thresholdDepth(depthPixels, thr);
                 }
-                dilateBinaryBgr(depthBgr.data(), depthW, depthH, g_dilateIterations.load());
+                dilateBinaryBgr(depthBgr.data(), depthW, depthH, dilateIterations(), &roi);
+                // The mask for /pointcloud, before blob rectangles are drawn over it
+                cloudWanted = showWeb && webServer.pointCloudWanted();
+                if (cloudWanted) foregroundMask(depthBgr.data(), depthW * depthH, cloudMask.data());
 
                 {
                     auto now2 = std::chrono::steady_clock::now();
@@ -359,45 +628,43 @@ int main(int argc, char* argv[]) {
                                   now2 - programStart).count();
 
                     if (g_blobDetectEnabled.load()) {
-                        auto blobs = detectAndDrawBlobs(depthBgr.data(), depthW, depthH,
-                                                        g_maxBlobPixels.load(), depthPixels,
-                                                        g_minBlobPixels.load());
-
-                        // Update persistent blob tracker (prints start/moved/end messages)
-                        tracker.update(blobs, frameCount, static_cast<long long>(ms));
-
-                        // Send tracked blob positions to web server as JSON
-                        if (showWeb) {
-                            const auto& tracked = tracker.activeBlobs();
-                            std::string json = "{\"w\":" + std::to_string(depthW) +
-                                               ",\"h\":" + std::to_string(depthH) +
-                                               ",\"blobs\":[";
-                            for (size_t i = 0; i < tracked.size(); i++) {
-                                const auto& t = tracked[i];
-                                if (i > 0) json += ",";
-                                json += "{\"id\":" + std::to_string(t.serial) +
-                                        ",\"cx\":" + std::to_string(t.cx) +
-                                        ",\"cy\":" + std::to_string(t.cy) +
-                                        ",\"avg\":" + std::to_string(static_cast<int>(t.avgDepthMm + 0.5f)) +
-                                        ",\"max\":" + std::to_string(static_cast<int>(t.maxDepthMm)) +
-                                        ",\"px\":" + std::to_string(t.pixelCount) + "}";
-                            }
-                            json += "]}";
-                            webServer.updateBlobs(json);
+                        auto blobs = incrementalLabeling
+                            ? tileLabeler.detect(depthBgr.data(), depthW, depthH,
+                                                 g_maxBlobPixels.load(), depthPixels,
+                                                 g_minBlobPixels.load(), &roi, zoneIds(), bandIds(),
+                                                 blobLabels, splitStepMm, maxBlobs, nearestFirst)
+                            : detectAndDrawBlobs(depthBgr.data(), depthW, depthH,
+                                                 g_maxBlobPixels.load(), depthPixels,
+                                                 g_minBlobPixels.load(), &roi, zoneIds(), bandIds(),
+                                                 &blobLabels, splitStepMm, maxBlobs, nearestFirst);
+                        shape.analyze(blobs, blobLabels, depthW, depthH, depthPixels);
+                        rays.apply(blobs);
+                        if (registration.ready()) {
+                            registration.sampleBlobColors(blobs, blobLabels, colorInDepth.data());
+                            if (showWindow)
+                                for (const auto& b : blobs) drawBlobRect(colorView.data(), depthW, depthH, b);
                         }
+
+                        countZoneBlobs(zoneOcc, blobs);
+
+                        // Update persistent blob tracker(s) (start/moved/end go to the event log)
+                        // and send tracked blob positions to the web server
+                        trackAndPublish(std::move(blobs), frameCount, static_cast<long long>(ms));
                     } else {
                         // Blob detection off — end any active tracked blobs
-                        tracker.update({}, frameCount, static_cast<long long>(ms));
+                        trackAndPublish({}, frameCount, static_cast<long long>(ms));
 
-                        std::printf("[%6d %7lldms]\n", frameCount, static_cast<long long>(ms));
-                        if (showWeb) {
-                            webServer.updateBlobs("{\"w\":" + std::to_string(depthW) +
-                                                  ",\"h\":" + std::to_string(depthH) +
-                                                  ",\"blobs\":[]}");
-                        }
+                        eventLog().push(LogEventType::Frame, LogLevel::Debug, frameCount, static_cast<long long>(ms));
                     }
                 }
 
+                // Point cloud, with the latest color as seen from each depth pixel
+                if (cloudWanted) {
+                    const uint8_t* alignedColor = registration.ready() ? colorInDepth.data() : nullptr;
+                    resolveForegroundMask(depthBgr.data(), depthW * depthH, cloudMask.data());
+                    webServer.updatePointCloud(depthPixels, cloudMask.data(), depthW, depthH,
+                                               rays.intrinsics(), alignedColor);
+                }
                 if (showWeb) webServer.updateDepthFrame(depthBgr.data(), depthW, depthH);
             }
 
@@ -441,5 +708,6 @@ int main(int argc, char* argv[]) {
 
     if (showWeb) webServer.stop();
     if (showWindow) viewer.shutdown();
+    eventLog().stop();
     return 0;
 }
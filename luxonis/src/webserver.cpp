@@ -1,5 +1,6 @@
 #include "webserver.hpp"
 
+#include <chrono>
 #include <cstdio>
 #include <cstring>
 #include <fstream>
@@ -11,6 +12,8 @@
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 #include "stb_image_write.h"
 
+#include "blobjson.hpp"
+#include "pointcloud.hpp"
 #include "webserver_common.hpp"
 #include "web_ui_shared.hpp"
 
@@ -448,6 +451,9 @@ void WebServer::stop() {
     blobsCv_.notify_all();   // wake any blocked SSE handlers
     depthCv_.notify_all();   // wake any blocked MJPEG handlers
     colorCv_.notify_all();
+    cloudCv_.notify_all();
+    tracksCv_.notify_all();
+    checkpointCv_.notify_all();
     if (thread_.joinable()) thread_.join();
 }
 
@@ -477,15 +483,88 @@ void WebServer::updateDepthFrame(const uint8_t* bgr, int width, int height) {
     depthCv_.notify_all();
 }
 
-void WebServer::updateBlobs(const std::string& json) {
+void WebServer::updateBlobs(const std::string& json, const std::string& binary) {
     {
         std::lock_guard<std::mutex> lock(frameMtx_);
         blobsJson_ = json;
+        blobsBin_ = binary;
         blobsSeq_++;
     }
     blobsCv_.notify_all();
 }
 
+static long long steadyMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool WebServer::pointCloudWanted() const {
+    return steadyMs() - cloudPollMs_.load() < 2000;
+}
+
+void WebServer::updatePointCloud(const uint16_t* depthMm, const uint8_t* mask, int width,
+                                 int height, const CameraIntrinsics& k, const uint8_t* colorBgr) {
+    {
+        std::lock_guard<std::mutex> lock(frameMtx_);
+        size_t n = static_cast<size_t>(width) * height;
+        cloudDepth_.assign(depthMm, depthMm + n);
+        cloudMask_.resize(n);
+        for (size_t i = 0; i < n; i++) cloudMask_[i] = mask[i] != 0;
+        if (colorBgr) cloudColor_.assign(colorBgr, colorBgr + n * 3);
+        else cloudColor_.clear();
+        cloudIntr_ = k;
+        cloudSeq_++;
+    }
+    cloudCv_.notify_all();
+}
+
+void WebServer::pushGestures(const std::vector<GestureEvent>& events) {
+    if (events.empty()) return;
+    {
+        std::lock_guard<std::mutex> lock(frameMtx_);
+        for (const auto& e : events) gestureRing_[gestureSeq_++ % kGestureRing] = e;
+    }
+    blobsCv_.notify_all();
+}
+
+bool WebServer::tracksWanted() const {
+    return steadyMs() - tracksPollMs_.load() < 2000;
+}
+
+void WebServer::updateTracks(const TrackHistorySnapshot& snap) {
+    {
+        std::lock_guard<std::mutex> lock(frameMtx_);
+        tracks_.ms = snap.ms;
+        tracks_.tracks = snap.tracks;
+        tracks_.samples = snap.samples;
+        tracksSeq_++;
+    }
+    tracksCv_.notify_all();
+}
+
+bool WebServer::checkpointWanted() const {
+    return steadyMs() - checkpointPollMs_.load() < 2000;
+}
+
+void WebServer::updateCheckpoint(const TrackerCheckpoint& cp) {
+    {
+        std::lock_guard<std::mutex> lock(frameMtx_);
+        checkpoint_ = cp;
+        checkpointSeq_++;
+    }
+    checkpointCv_.notify_all();
+}
+
+PipelineSettings WebServer::getPipelineSettings() {
+    std::lock_guard<std::mutex> lock(pipelineMtx_);
+    return pipeline_;
+}
+
+void WebServer::updatePlaneStatus(const std::string& json) {
+    std::lock_guard<std::mutex> lock(pipelineMtx_);
+    planeStatus_ = json;
+}
+
 PostProcSettings WebServer::getPostProcSettings() {
     std::lock_guard<std::mutex> lock(postProcMtx_);
     return postProc_;
@@ -503,6 +582,7 @@ void WebServer::saveSettings() {
     PostProcSettings pp;
     std::string sScale, sQuantize;
     { std::lock_guard<std::mutex> lock(postProcMtx_); pp = postProc_; sScale = soundScale_; sQuantize = soundQuantize_; }
+    PipelineSettings ps = getPipelineSettings();
 
     std::string json = "{\n"
         + saveSharedSettingsJson(thresholdMm_.load(), thresholdEnabled_.load(),
@@ -512,6 +592,8 @@ void WebServer::saveSettings() {
             soundDecay_.load(), soundRelease_.load(), soundMoveThresh_.load(),
             sQuantize, soundVolume_.load(), soundTempo_.load(), showDepth_.load())
         + ",\n"
+        + savePipelineSettingsJson(ps)
+        + ",\n"
         // Luxonis-specific fields
         "  \"confidenceThreshold\": " + std::to_string(confidenceThreshold_.load()) + ",\n"
         "  \"extendedDisparity\": " + (extendedDisparity_.load() ? "true" : "false") + ",\n"
@@ -563,6 +645,11 @@ void WebServer::loadSettings() {
         soundMode_, soundKey_, soundDecay_, soundRelease_, soundMoveThresh_,
         soundVolume_, soundTempo_, showDepth_);
 
+    {
+        std::lock_guard<std::mutex> lock(pipelineMtx_);
+        loadPipelineSettings(text, pipeline_);
+    }
+
     int iv; bool bv; std::string sv;
 
     // Luxonis-specific atomics
@@ -621,11 +708,15 @@ void WebServer::run() {
         + "\n<h1>DepthPalette (Luxonis)</h1>\n"
         + kSharedControls
         + kLuxonisControls
+        + kSharedRegionControls
+        + kSharedShapeControls
         + kSharedImages
         + "\n<script>\n"
         + kSharedSoundJs
         + kSharedHandlersJs
         + kLuxonisScript
+        + kSharedRegionJs
+        + kSharedShapeJs
         + kSharedInitJs
         + "\n</script>\n</body>\n</html>";
 
@@ -774,14 +865,29 @@ void WebServer::run() {
             dilateIterations_.store(val);
             changed = true;
         }
+        if (req.has_param("weak")) {
+            int val = std::stoi(req.get_param_value("weak"));
+            if (val < 0) val = 0;
+            if (val > 300) val = 300;
+            {
+                std::lock_guard<std::mutex> lock(pipelineMtx_);
+                pipeline_.hysteresisMm = val;
+            }
+            pipelineSeq_++;
+            changed = true;
+        }
         if (changed) saveSettings();
         res.set_content("{\"threshold\":" + std::to_string(thresholdMm_.load()) +
                         ",\"enabled\":" + (thresholdEnabled_.load() ? "true" : "false") +
-                        ",\"dilate\":" + std::to_string(dilateIterations_.load()) + "}",
+                        ",\"dilate\":" + std::to_string(dilateIterations_.load()) +
+                        ",\"weak\":" + std::to_string(getPipelineSettings().hysteresisMm) + "}",
                         "application/json");
     });
 
-    // GET /blobdetect — get or set blob detection settings
+    // GET /blobdetect — get or set blob detection settings. ?delta=1 publishes
+    // blobs only when something changed beyond ?deltapx / ?deltamm (tracks,
+    // tips, zone occupancy; see blobpublish.hpp) plus every ?keyframe ms; each
+    // published frame is still a full snapshot of all blobs, not the changes.
     svr.Get("/blobdetect", [this](const httplib::Request& req, httplib::Response& res) {
         bool changed = false;
         if (req.has_param("enabled")) {
@@ -802,16 +908,298 @@ void WebServer::run() {
             minBlobPixels_.store(val);
             changed = true;
         }
+        if (req.has_param("split")) {
+            int val = std::stoi(req.get_param_value("split"));
+            if (val < 0) val = 0;
+            if (val > 500) val = 500;
+            {
+                std::lock_guard<std::mutex> lock(pipelineMtx_);
+                pipeline_.splitStepMm = val;
+            }
+            pipelineSeq_++;
+            changed = true;
+        }
+        if (req.has_param("topk") || req.has_param("rank")) {
+            std::lock_guard<std::mutex> lock(pipelineMtx_);
+            if (req.has_param("topk")) {
+                int val = std::stoi(req.get_param_value("topk"));
+                if (val < 0) val = 0;
+                if (val > 64) val = 64;
+                pipeline_.maxBlobs = val;
+            }
+            if (req.has_param("rank")) pipeline_.nearestFirst = req.get_param_value("rank") == "nearest";
+            pipelineSeq_++;
+            changed = true;
+        }
+        if (req.has_param("incremental")) {
+            {
+                std::lock_guard<std::mutex> lock(pipelineMtx_);
+                pipeline_.incrementalLabeling = req.get_param_value("incremental") == "1";
+            }
+            pipelineSeq_++;
+            changed = true;
+        }
+        if (req.has_param("assign")) {
+            {
+                std::lock_guard<std::mutex> lock(pipelineMtx_);
+                pipeline_.optimalAssignment = req.get_param_value("assign") == "optimal";
+            }
+            pipelineSeq_++;
+            changed = true;
+        }
+        if (req.has_param("confirm") || req.has_param("coast")) {
+            std::lock_guard<std::mutex> lock(pipelineMtx_);
+            if (req.has_param("confirm")) {
+                int val = std::stoi(req.get_param_value("confirm"));
+                if (val < 1) val = 1;
+                if (val > 30) val = 30;
+                pipeline_.confirmFrames = val;
+            }
+            if (req.has_param("coast")) {
+                int val = std::stoi(req.get_param_value("coast"));
+                if (val < 0) val = 0;
+                if (val > 30) val = 30;
+                pipeline_.coastFrames = val;
+            }
+            pipelineSeq_++;
+            changed = true;
+        }
+        if (req.has_param("gate")) {
+            {
+                std::lock_guard<std::mutex> lock(pipelineMtx_);
+                int val = std::stoi(req.get_param_value("gate"));
+                if (val < 0) val = 0;
+                if (val > 500) val = 500;
+                pipeline_.matchGateMm = val;
+            }
+            pipelineSeq_++;
+            changed = true;
+        }
+        if (req.has_param("delta") || req.has_param("deltapx") || req.has_param("deltamm") ||
+            req.has_param("keyframe")) {
+            std::lock_guard<std::mutex> lock(pipelineMtx_);
+            if (req.has_param("delta")) pipeline_.deltaPublish = req.get_param_value("delta") == "1";
+            if (req.has_param("deltapx")) {
+                int val = std::stoi(req.get_param_value("deltapx"));
+                if (val < 0) val = 0;
+                if (val > 100) val = 100;
+                pipeline_.deltaPx = val;
+            }
+            if (req.has_param("deltamm")) {
+                int val = std::stoi(req.get_param_value("deltamm"));
+                if (val < 0) val = 0;
+                if (val > 500) val = 500;
+                pipeline_.deltaMm = val;
+            }
+            if (req.has_param("keyframe")) {
+                int val = std::stoi(req.get_param_value("keyframe"));
+                if (val < 100) val = 100;
+                if (val > 10000) val = 10000;
+                pipeline_.keyframeMs = val;
+            }
+            pipelineSeq_++;
+            changed = true;
+        }
         if (changed) saveSettings();
         bool enabled = blobDetectEnabled_.load();
         int maxsz = maxBlobPixels_.load();
         int minsz = minBlobPixels_.load();
+        auto ps = getPipelineSettings();
         res.set_content("{\"enabled\":" + std::string(enabled ? "true" : "false") +
                         ",\"maxsize\":" + std::to_string(maxsz) +
-                        ",\"minsize\":" + std::to_string(minsz) + "}",
+                        ",\"minsize\":" + std::to_string(minsz) +
+                        ",\"split\":" + std::to_string(ps.splitStepMm) +
+                        ",\"topk\":" + std::to_string(ps.maxBlobs) +
+                        ",\"rank\":\"" + (ps.nearestFirst ? "nearest" : "largest") + "\"" +
+                        ",\"incremental\":" + (ps.incrementalLabeling ? "true" : "false") +
+                        ",\"assign\":\"" + (ps.optimalAssignment ? "optimal" : "greedy") + "\"" +
+                        ",\"confirm\":" + std::to_string(ps.confirmFrames) +
+                        ",\"coast\":" + std::to_string(ps.coastFrames) +
+                        ",\"gate\":" + std::to_string(ps.matchGateMm) +
+                        ",\"delta\":" + (ps.deltaPublish ? "true" : "false") +
+                        ",\"deltapx\":" + std::to_string(ps.deltaPx) +
+                        ",\"deltamm\":" + std::to_string(ps.deltaMm) +
+                        ",\"keyframe\":" + std::to_string(ps.keyframeMs) + "}",
                         "application/json");
     });
 
+    // GET /roi — get or set region of interest (crop rectangle + exclusion polygons)
+    svr.Get("/roi", [this](const httplib::Request& req, httplib::Response& res) {
+        bool changed = false;
+        {
+            std::lock_guard<std::mutex> lock(pipelineMtx_);
+            if (req.has_param("enabled")) {
+                pipeline_.roiEnabled = req.get_param_value("enabled") == "1";
+                changed = true;
+            }
+            if (req.has_param("crop")) {
+                pipeline_.roiCrop = sanitizeRoiSpec(req.get_param_value("crop"));
+                changed = true;
+            }
+            if (req.has_param("exclude")) {
+                pipeline_.roiExclude = sanitizeRoiSpec(req.get_param_value("exclude"));
+                changed = true;
+            }
+        }
+        if (changed) {
+            pipelineSeq_++;
+            saveSettings();
+        }
+        res.set_content(roiSettingsJson(getPipelineSettings()), "application/json");
+    });
+
+    // GET /zones — get or set multi-zone segmentation (per-zone near/far bands)
+    svr.Get("/zones", [this](const httplib::Request& req, httplib::Response& res) {
+        bool changed = false;
+        {
+            std::lock_guard<std::mutex> lock(pipelineMtx_);
+            if (req.has_param("enabled")) {
+                pipeline_.zonesEnabled = req.get_param_value("enabled") == "1";
+                changed = true;
+            }
+            if (req.has_param("spec")) {
+                pipeline_.zones = sanitizeZoneSpec(req.get_param_value("spec"));
+                changed = true;
+            }
+        }
+        if (changed) {
+            pipelineSeq_++;
+            saveSettings();
+        }
+        res.set_content(zoneSettingsJson(getPipelineSettings()), "application/json");
+    });
+
+    // GET /bands — get or set depth bands (independent blob layers per band)
+    svr.Get("/bands", [this](const httplib::Request& req, httplib::Response& res) {
+        bool changed = false;
+        {
+            std::lock_guard<std::mutex> lock(pipelineMtx_);
+            if (req.has_param("enabled")) {
+                pipeline_.bandsEnabled = req.get_param_value("enabled") == "1";
+                changed = true;
+            }
+            if (req.has_param("spec")) {
+                pipeline_.bands = sanitizeBandSpec(req.get_param_value("spec"));
+                changed = true;
+            }
+        }
+        if (changed) {
+            pipelineSeq_++;
+            saveSettings();
+        }
+        res.set_content(bandSettingsJson(getPipelineSettings()), "application/json");
+    });
+
+    // GET /contours — get or set blob outline tracing (Douglas-Peucker epsilon in px,
+    // vertex limit per outline) and the number of extremities (fingertips) reported per blob
+    svr.Get("/contours", [this](const httplib::Request& req, httplib::Response& res) {
+        bool changed = false;
+        {
+            std::lock_guard<std::mutex> lock(pipelineMtx_);
+            if (req.has_param("enabled")) {
+                pipeline_.contoursEnabled = req.get_param_value("enabled") == "1";
+                changed = true;
+            }
+            if (req.has_param("epsilon")) {
+                int val = std::stoi(req.get_param_value("epsilon"));
+                if (val < 1) val = 1;
+                if (val > 20) val = 20;
+                pipeline_.contourEpsilonPx = val;
+                changed = true;
+            }
+            if (req.has_param("vertices")) {
+                int val = std::stoi(req.get_param_value("vertices"));
+                if (val < 0) val = 0;
+                if (val > 0 && val < 8) val = 8;
+                if (val > 1024) val = 1024;
+                pipeline_.contourMaxVertices = val;
+                changed = true;
+            }
+            if (req.has_param("tips")) {
+                int val = std::stoi(req.get_param_value("tips"));
+                if (val < 0) val = 0;
+                if (val > 10) val = 10;
+                pipeline_.maxTips = val;
+                changed = true;
+            }
+        }
+        if (changed) {
+            pipelineSeq_++;
+            saveSettings();
+        }
+        res.set_content(contourSettingsJson(getPipelineSettings()), "application/json");
+    });
+
+    // GET /gestures — gesture recognizer settings (see gestures.hpp); events go
+    // out on /events ("gesture") and /gestures.bin
+    svr.Get("/gestures", [this](const httplib::Request& req, httplib::Response& res) {
+        bool changed = false;
+        auto intParam = [&](const char* name, int lo, int hi, int& field) {
+            if (!req.has_param(name)) return;
+            int val = std::stoi(req.get_param_value(name));
+            if (val < lo) val = lo;
+            if (val > hi) val = hi;
+            field = val;
+            changed = true;
+        };
+        {
+            std::lock_guard<std::mutex> lock(pipelineMtx_);
+            if (req.has_param("enabled")) {
+                pipeline_.gesturesEnabled = req.get_param_value("enabled") == "1";
+                changed = true;
+            }
+            intParam("tap", 50, 2000, pipeline_.tapMaxMs);
+            intParam("hold", 100, 5000, pipeline_.holdMs);
+            intParam("still", 1, 200, pipeline_.stillRadiusPx);
+            intParam("speed", 50, 10000, pipeline_.swipeSpeed);
+            intParam("swipe", 5, 1000, pipeline_.swipeMinPx);
+            intParam("pinch", 1, 100, pipeline_.pinchStepPct);
+        }
+        if (changed) {
+            pipelineSeq_++;
+            saveSettings();
+        }
+        res.set_content(gestureSettingsJson(getPipelineSettings()), "application/json");
+    });
+
+    // GET /plane — surface plane segmentation settings and fitted plane; refit=1 forces a refit
+    svr.Get("/plane", [this](const httplib::Request& req, httplib::Response& res) {
+        bool changed = false;
+        std::string body;
+        {
+            std::lock_guard<std::mutex> lock(pipelineMtx_);
+            if (req.has_param("enabled")) {
+                pipeline_.planeEnabled = req.get_param_value("enabled") == "1";
+                changed = true;
+            }
+            if (req.has_param("min")) {
+                int val = std::stoi(req.get_param_value("min"));
+                if (val < 0) val = 0;
+                if (val > 500) val = 500;
+                pipeline_.planeMinMm = val;
+                changed = true;
+            }
+            if (req.has_param("max")) {
+                int val = std::stoi(req.get_param_value("max"));
+                if (val < 10) val = 10;
+                if (val > 2000) val = 2000;
+                pipeline_.planeMaxMm = val;
+                changed = true;
+            }
+            if (req.has_param("intrinsics")) {
+                pipeline_.intrinsics = sanitizeRoiSpec(req.get_param_value("intrinsics"));
+                changed = true;
+            }
+            body = planeSettingsJson(pipeline_, planeStatus_);
+        }
+        if (req.has_param("refit")) planeRefit_.store(true);
+        if (changed) {
+            pipelineSeq_++;
+            saveSettings();
+        }
+        res.set_content(body, "application/json");
+    });
+
     // GET /stereoconfig — get or set stereo depth settings
     svr.Get("/stereoconfig", [this](const httplib::Request& req, httplib::Response& res) {
         bool changed = false;
@@ -1229,13 +1617,179 @@ void WebServer::run() {
         res.set_content(body, "application/octet-stream");
     });
 
+    // GET /pointcloud — deprojected depth frame (see pointcloud.hpp); long-polls like
+    // depth.raw. ?stride=N decimates, ?crop=x0,y0,x1,y1 (normalized) crops, ?fg=1
+    // keeps foreground pixels only, ?color=1 adds RGB, ?format=ply for binary PLY.
+    svr.Get("/pointcloud", [this](const httplib::Request& req, httplib::Response& res) {
+        res.set_header("Cache-Control", "no-cache");
+        res.set_header("Access-Control-Allow-Origin", "*");
+        cloudPollMs_ = steadyMs();
+        int clientSeq = 0;
+        if (req.has_param("seq")) clientSeq = std::stoi(req.get_param_value("seq"));
+        PointCloudOptions opt;
+        if (req.has_param("stride")) opt.stride = std::stoi(req.get_param_value("stride"));
+        if (opt.stride < 1) opt.stride = 1;
+        if (opt.stride > 16) opt.stride = 16;
+        opt.foregroundOnly = req.has_param("fg") && req.get_param_value("fg") == "1";
+        opt.color = req.has_param("color") && req.get_param_value("color") == "1";
+        opt.ply = req.has_param("format") && req.get_param_value("format") == "ply";
+        float crop[4] = {0.0f, 0.0f, 1.0f, 1.0f};
+        opt.crop = req.has_param("crop") && parseRoiCrop(req.get_param_value("crop"), crop);
+        {
+            std::unique_lock<std::mutex> lock(frameMtx_);
+            cloudCv_.wait_for(lock, std::chrono::seconds(2),
+                [&] { return cloudSeq_ > clientSeq || !running_; });
+        }
+
+        // Per-connection buffers: a polling client reuses them frame after frame
+        thread_local std::vector<uint16_t> depth;
+        thread_local std::vector<uint8_t> mask;
+        thread_local std::vector<uint8_t> colorBgr;
+        thread_local DepthRays rays;
+        thread_local std::string body;
+        CameraIntrinsics k;
+        PointCloudColor color;
+        int seq;
+        {
+            std::lock_guard<std::mutex> lock(frameMtx_);
+            if (cloudDepth_.empty()) { res.status = 204; return; }
+            depth = cloudDepth_;
+            if (opt.foregroundOnly) mask = cloudMask_;
+            k = cloudIntr_;
+            seq = cloudSeq_;
+            if (opt.color && !cloudColor_.empty()) {
+                colorBgr = cloudColor_;
+                color.width = k.width;
+                color.height = k.height;
+            } else if (opt.color && !colorBgr_.empty()) {
+                colorBgr = colorBgr_;
+                color.width = colorW_;
+                color.height = colorH_;
+            }
+        }
+        if (color.width > 0) {
+            color.bgr = colorBgr.data();
+            color.depthW = k.width;
+            color.depthH = k.height;
+        }
+        rays.configure(k);
+        // Rounded like compileRoiSpans; buildPointCloud orders the corners
+        opt.x0 = static_cast<int>(crop[0] * k.width + 0.5f);
+        opt.y0 = static_cast<int>(crop[1] * k.height + 0.5f);
+        opt.x1 = static_cast<int>(crop[2] * k.width + 0.5f);
+        opt.y1 = static_cast<int>(crop[3] * k.height + 0.5f);
+        buildPointCloud(depth.data(), opt.foregroundOnly ? mask.data() : nullptr, k.width, k.height,
+                        rays, opt, color, static_cast<uint32_t>(seq), body);
+        res.set_header("X-Frame-Seq", std::to_string(seq));
+        res.set_content(body, opt.ply ? "application/x-ply" : "application/octet-stream");
+    });
+
+    // GET /tracks — recent path of every tracked blob (see tracksJson). The
+    // histories are only pushed while someone asks, so the first request waits
+    // for the next frame. ?id=N for one track, ?band=N for one layer, ?n=N for
+    // the newest N samples per track.
+    svr.Get("/tracks", [this](const httplib::Request& req, httplib::Response& res) {
+        res.set_header("Cache-Control", "no-cache");
+        res.set_header("Access-Control-Allow-Origin", "*");
+        bool fresh = tracksWanted();
+        tracksPollMs_ = steadyMs();
+        int id = -1, band = -1, n = 0;
+        if (req.has_param("id")) id = std::stoi(req.get_param_value("id"));
+        if (req.has_param("band")) band = std::stoi(req.get_param_value("band"));
+        if (req.has_param("n")) n = std::stoi(req.get_param_value("n"));
+        thread_local TrackHistorySnapshot snap;
+        {
+            std::unique_lock<std::mutex> lock(frameMtx_);
+            if (!fresh) {
+                int seq = tracksSeq_;
+                tracksCv_.wait_for(lock, std::chrono::milliseconds(500),
+                    [&] { return tracksSeq_ != seq || !running_; });
+            }
+            if (tracksSeq_ == 0) { res.status = 204; return; }
+            snap.ms = tracks_.ms;
+            snap.tracks = tracks_.tracks;
+            snap.samples = tracks_.samples;
+        }
+        res.set_content(tracksJson(snap, id, band, n), "application/json");
+    });
+
+    // GET /checkpoint — the trackers' next serials and the last position of
+    // every published track (see checkpointJson), the same state the frame
+    // loop carries across pipeline restarts. Pushed only while someone asks,
+    // like /tracks.
+    svr.Get("/checkpoint", [this](const httplib::Request&, httplib::Response& res) {
+        res.set_header("Cache-Control", "no-cache");
+        res.set_header("Access-Control-Allow-Origin", "*");
+        bool fresh = checkpointWanted();
+        checkpointPollMs_ = steadyMs();
+        thread_local TrackerCheckpoint cp;
+        {
+            std::unique_lock<std::mutex> lock(frameMtx_);
+            if (!fresh) {
+                int seq = checkpointSeq_;
+                checkpointCv_.wait_for(lock, std::chrono::milliseconds(500),
+                    [&] { return checkpointSeq_ != seq || !running_; });
+            }
+            if (checkpointSeq_ == 0) { res.status = 204; return; }
+            cp = checkpoint_;
+        }
+        res.set_content(checkpointJson(cp), "application/json");
+    });
+
+    // GET /gestures.bin — gestures after ?seq=N (see blobjson.hpp), long-polls
+    // until there is one; without seq only new gestures are returned.
+    svr.Get("/gestures.bin", [this](const httplib::Request& req, httplib::Response& res) {
+        res.set_header("Cache-Control", "no-cache");
+        res.set_header("Access-Control-Allow-Origin", "*");
+        thread_local std::vector<GestureEvent> events;
+        events.clear();
+        int firstSeq;
+        {
+            std::unique_lock<std::mutex> lock(frameMtx_);
+            int clientSeq = req.has_param("seq") ? std::stoi(req.get_param_value("seq")) : gestureSeq_;
+            blobsCv_.wait_for(lock, std::chrono::seconds(2),
+                [&] { return gestureSeq_ > clientSeq || !running_; });
+            if (clientSeq > gestureSeq_) clientSeq = gestureSeq_;   // server restarted numbering
+            if (gestureSeq_ - clientSeq > kGestureRing) clientSeq = gestureSeq_ - kGestureRing;
+            firstSeq = clientSeq + 1;
+            for (int s = firstSeq; s <= gestureSeq_; s++) events.push_back(gestureRing_[(s - 1) % kGestureRing]);
+        }
+        res.set_content(gesturesBinary(events, firstSeq), "application/octet-stream");
+    });
+
+    // GET /blobs.bin — binary blob frame (see blobjson.hpp); long-polls like depth.raw
+    svr.Get("/blobs.bin", [this](const httplib::Request& req, httplib::Response& res) {
+        res.set_header("Cache-Control", "no-cache");
+        res.set_header("Access-Control-Allow-Origin", "*");
+        int clientSeq = 0;
+        if (req.has_param("seq")) clientSeq = std::stoi(req.get_param_value("seq"));
+        {
+            std::unique_lock<std::mutex> lock(frameMtx_);
+            blobsCv_.wait_for(lock, std::chrono::seconds(2),
+                [&] { return blobsSeq_ > clientSeq || !running_; });
+        }
+        std::string body;
+        {
+            std::lock_guard<std::mutex> lock(frameMtx_);
+            if (blobsBin_.size() < kBlobBinHeaderSize) { res.status = 204; return; }
+            body = blobsBin_;
+            putU32(body, 4, static_cast<uint32_t>(blobsSeq_));
+        }
+        res.set_content(body, "application/octet-stream");
+    });
+
     // GET /events — SSE stream of blob/cursor updates
     svr.Get("/events", [this](const httplib::Request&, httplib::Response& res) {
         res.set_header("Cache-Control", "no-cache");
         res.set_header("Access-Control-Allow-Origin", "*");
+        int lastGesture;
+        {
+            std::lock_guard<std::mutex> lock(frameMtx_);
+            lastGesture = gestureSeq_;
+        }
         res.set_chunked_content_provider(
             "text/event-stream",
-            [this](size_t /*offset*/, httplib::DataSink& sink) {
+            [this, lastGesture](size_t /*offset*/, httplib::DataSink& sink) mutable {
                 int lastSeq;
                 {
                     std::lock_guard<std::mutex> lock(frameMtx_);
@@ -1245,17 +1799,21 @@ void WebServer::run() {
                 {
                     std::unique_lock<std::mutex> lock(frameMtx_);
                     blobsCv_.wait_for(lock, std::chrono::seconds(5),
-                                      [&] { return blobsSeq_ != lastSeq || !running_; });
+                                      [&] { return blobsSeq_ != lastSeq || gestureSeq_ != lastGesture || !running_; });
                 }
                 if (!running_) return false;
-                // Send current blob data as SSE event
-                std::string json;
+                // Send new gestures as "gesture" events, then the current blob data
+                std::string json, event;
                 {
                     std::lock_guard<std::mutex> lock(frameMtx_);
                     json = blobsJson_;
+                    if (gestureSeq_ - lastGesture > kGestureRing) lastGesture = gestureSeq_ - kGestureRing;
+                    for (int s = lastGesture + 1; s <= gestureSeq_; s++)
+                        event += "event: gesture\ndata: " + gestureJson(gestureRing_[(s - 1) % kGestureRing], s) + "\n\n";
+                    lastGesture = gestureSeq_;
                 }
                 if (json.empty()) json = "{\"w\":0,\"h\":0,\"blobs\":[]}";
-                std::string event = "data: " + json + "\n\n";
+                event += "data: " + json + "\n\n";
                 sink.write(event.data(), event.size());
                 return true;
             });
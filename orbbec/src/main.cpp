@@ -1,6 +1,6 @@
 #include <atomic>
 #include <chrono>
-#include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <iostream>
 #include <string>
@@ -9,9 +9,20 @@
 
 #include <libobsensor/ObSensor.hpp>
 
+#include "bands.hpp"
 #include "blobdetect.hpp"
+#include "blobjson.hpp"
+#include "blobpublish.hpp"
+#include "blobshape.hpp"
 #include "blobtracker.hpp"
+#include "deproject.hpp"
 #include "depthcolor.hpp"
+#include "eventlog.hpp"
+#include "intrinsics.hpp"
+#include "plane.hpp"
+#include "registration.hpp"
+#include "tilelabel.hpp"
+#include "zones.hpp"
 #ifdef VIEWER_LINUX
 #include "viewer_linux.hpp"
 #else
@@ -33,6 +44,9 @@ static std::atomic<int> g_depthResolution{0};   // 0=1280x800, 1=848x480
 static std::atomic<int> g_cameraFps{30};
 static std::atomic<bool> g_devicePropsDirty{false};
 
+// Nominal depth HFOV, used only when the device reports no intrinsics
+static constexpr float kDepthHfovDeg = 90.0f;
+
 // Helper: query an int property range, returning a PropertyRange
 static PropertyRange queryIntRange(std::shared_ptr<ob::Device> device, OBPropertyID prop) {
     PropertyRange r;
@@ -300,6 +314,10 @@ int main(int argc, char* argv[]) {
     bool showWindow = false;
     bool showColor = false;
     bool showWeb = true;
+    std::string registrationFile;   // depth->color calibration, overrides the device's
+    LogLevel logLevel = LogLevel::Info;   // cursor moves and frame ticks are debug
+    int logRate = 100;                    // text lines per second, 0 = unlimited
+    std::string eventLogFile;             // binary copy of every log record
     for (int i = 1; i < argc; i++) {
         if (std::strcmp(argv[i], "--window") == 0 || std::strcmp(argv[i], "-w") == 0) {
             showWindow = true;
@@ -309,8 +327,18 @@ int main(int argc, char* argv[]) {
             showWeb = false;
         } else if (std::strcmp(argv[i], "--no-blob") == 0) {
             g_blobDetectEnabled.store(false);
+        } else if (std::strcmp(argv[i], "--registration") == 0 && i + 1 < argc) {
+            registrationFile = argv[++i];
+        } else if (std::strcmp(argv[i], "--log-level") == 0 && i + 1 < argc) {
+            if (!parseLogLevel(argv[++i], logLevel))
+                std::cerr << "Unknown log level " << argv[i] << " (debug, info, warn, off)" << std::endl;
+        } else if (std::strcmp(argv[i], "--log-rate") == 0 && i + 1 < argc) {
+            logRate = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--event-log") == 0 && i + 1 < argc) {
+            eventLogFile = argv[++i];
         }
     }
+    eventLog().start(logLevel, logRate, eventLogFile);
 
     // Optional Win32 viewer window
     ImageViewer viewer;
@@ -325,6 +353,7 @@ int main(int argc, char* argv[]) {
     if (showWeb) webServer.start();
 
     auto programStart = std::chrono::steady_clock::now();
+    TrackerCheckpoint checkpoint;   // tracker state carried across pipeline restarts
 
     // Outer loop: recreate pipeline when settings require restart
     while (true) {
@@ -498,6 +527,31 @@ int main(int argc, char* argv[]) {
         std::cout << "Depth: " << depthW << "x" << depthH
                   << " scale=" << depthScale << std::endl;
 
+        // Depth intrinsics from the device calibration (plane fitting, metric blob positions),
+        // and the color intrinsics plus depth->color transform (registration)
+        CameraIntrinsics deviceIntr;
+        CameraIntrinsics colorIntr;
+        CameraExtrinsics colorExt;
+        try {
+            OBCameraParam param = pipe.getCameraParam();
+            OBCameraIntrinsic di = param.depthIntrinsic;
+            deviceIntr.width = di.width;
+            deviceIntr.height = di.height;
+            deviceIntr.fx = di.fx;
+            deviceIntr.fy = di.fy;
+            deviceIntr.cx = di.cx;
+            deviceIntr.cy = di.cy;
+            OBCameraIntrinsic ci = param.rgbIntrinsic;
+            colorIntr.width = ci.width;
+            colorIntr.height = ci.height;
+            colorIntr.fx = ci.fx;
+            colorIntr.fy = ci.fy;
+            colorIntr.cx = ci.cx;
+            colorIntr.cy = ci.cy;
+            for (int k = 0; k < 9; k++) colorExt.r[k] = param.transform.rot[k];
+            for (int k = 0; k < 3; k++) colorExt.t[k] = param.transform.trans[k];
+        } catch (...) {}
+
         // Color stream (optional)
         int colorW = 0, colorH = 0;
         if (showColor) {
@@ -511,6 +565,9 @@ int main(int argc, char* argv[]) {
                 std::cerr << "Warning: no color frame in first frameset" << std::endl;
             }
         }
+        if (colorW > 0 && !registrationFile.empty() &&
+            !loadRegistrationFile(registrationFile, colorIntr, colorExt))
+            std::cerr << "Warning: could not read registration file " << registrationFile << std::endl;
 
         if (showWindow && !viewer.isInitialized()) {
             int windowW = showColor ? colorW + depthW : depthW;
@@ -529,6 +586,125 @@ int main(int argc, char* argv[]) {
         std::vector<uint8_t> depthBgr(depthW * depthH * 3);
         std::vector<uint16_t> depthMm(depthW * depthH);  // depth in mm
 
+        // Region of interest spans and zone map — recompiled only when the web UI changes them
+        RoiSpans roi;
+        ZoneMap zones;
+        ZoneOccupancy zoneOcc;
+        zoneOcc.clear();
+        uint16_t hysteresisMm = 0;
+        PlaneEstimator plane;
+        bool planeEnabled = false;
+        DepthBands bands;
+        std::string bandSpec = "-";
+        std::vector<uint8_t> bandMap(depthW * depthH);
+        BlobTracker tracker;
+        std::vector<BlobTracker> bandTrackers;    // one id space per depth band
+        BlobPublishFilter publishFilter;          // skips frames where nothing moved
+        bool zonesUsed = false;                   // segmentation used for the current frame
+        bool bandsUsed = false;
+        std::vector<int> blobLabels(depthW * depthH);   // label image for the shape stage
+        BlobShapeAnalyzer shape;
+        int splitStepMm = 0;
+        int maxBlobs = 0;
+        bool nearestFirst = false;
+        IncrementalLabeler tileLabeler;
+        bool incrementalLabeling = false;
+        DepthRays rays;                           // pixel -> camera-space mm
+        DepthColorRegistration registration;      // color mode only (see below)
+        std::vector<uint8_t> colorInDepth(colorW > 0 ? depthW * depthH * 3 : 0);   // registered color
+        std::vector<uint8_t> colorView(colorInDepth.size());   // registered color + blob boxes, for the window
+        std::vector<uint8_t> cloudMask(depthW * depthH);   // foreground for /pointcloud
+        int pipelineSeq = -1;
+        auto refreshPipelineSettings = [&]() {
+            int seq = webServer.pipelineSettingsSeq();
+            if (seq == pipelineSeq) return;
+            pipelineSeq = seq;
+            auto ps = webServer.getPipelineSettings();
+            compileRoiSpans(roi, depthW, depthH, ps.roiEnabled, ps.roiCrop, ps.roiExclude);
+            compileZoneMap(zones, depthW, depthH, ps.zonesEnabled, ps.zones);
+            hysteresisMm = static_cast<uint16_t>(ps.hysteresisMm);
+            planeEnabled = ps.planeEnabled;
+            CameraIntrinsics intr = resolveIntrinsics(ps.intrinsics, deviceIntr, depthW, depthH,
+                                                      kDepthHfovDeg);
+            plane.configure(intr, ps.planeMinMm, ps.planeMaxMm);
+            rays.configure(intr);
+            if (colorW > 0) registration.configure(intr, scaleIntrinsics(colorIntr, colorW, colorH), colorExt);
+            webServer.updatePlaneStatus(plane.json());
+            splitStepMm = ps.splitStepMm;
+            maxBlobs = ps.maxBlobs;
+            nearestFirst = ps.nearestFirst;
+            incrementalLabeling = ps.incrementalLabeling;
+            tileLabeler.reset();
+            shape.configure(ps.contoursEnabled ? static_cast<float>(ps.contourEpsilonPx) : 0.0f,
+                            ps.contourMaxVertices, ps.maxTips);
+            std::string spec = ps.bandsEnabled ? ps.bands : std::string();
+            if (spec != bandSpec) {
+                bandSpec = spec;
+                compileDepthBands(bands, ps.bandsEnabled, spec);
+                bandTrackers.assign(bands.count, BlobTracker());
+            }
+            tracker.setOptimalAssignment(ps.optimalAssignment);
+            for (auto& t : bandTrackers) t.setOptimalAssignment(ps.optimalAssignment);
+            tracker.setLifecycle(ps.confirmFrames, ps.coastFrames);
+            for (auto& t : bandTrackers) t.setLifecycle(ps.confirmFrames, ps.coastFrames);
+            tracker.setMatchGate(static_cast<float>(ps.matchGateMm), intr.fx, intr.width);
+            for (auto& t : bandTrackers) t.setMatchGate(static_cast<float>(ps.matchGateMm), intr.fx, intr.width);
+            GestureSettings gestures;
+            gestures.enabled = ps.gesturesEnabled;
+            gestures.tapMaxMs = ps.tapMaxMs;
+            gestures.holdMs = ps.holdMs;
+            gestures.stillRadiusPx = static_cast<float>(ps.stillRadiusPx);
+            gestures.swipeSpeed = static_cast<float>(ps.swipeSpeed);
+            gestures.swipeMinPx = static_cast<float>(ps.swipeMinPx);
+            gestures.pinchStep = ps.pinchStepPct / 100.0f;
+            tracker.setGestures(gestures);
+            for (auto& t : bandTrackers) t.setGestures(gestures);
+            publishFilter.configure(ps.deltaPublish, ps.deltaPx, ps.deltaMm, ps.keyframeMs);
+        };
+        refreshPipelineSettings();
+
+        // Pick up the tracks of the previous run so hands keep their ids
+        // (band trackers only if the bands are unchanged)
+        if (checkpoint.width > 0) {
+            float sx = static_cast<float>(depthW) / checkpoint.width;
+            float sy = static_cast<float>(depthH) / checkpoint.height;
+            tracker.restoreState(checkpoint.single, sx, sy, checkpoint.ms);
+            if (checkpoint.bands == bandSpec && checkpoint.bandStates.size() == bandTrackers.size())
+                for (size_t i = 0; i < bandTrackers.size(); i++)
+                    bandTrackers[i].restoreState(checkpoint.bandStates[i], sx, sy, checkpoint.ms);
+        }
+
+        // Threshold pass, first match wins: height above the fitted surface when the
+        // plane is enabled, depth bands, per-zone bands (with occupancy), global threshold.
+        // With hysteresis the weak band is written gray and resolved while labeling
+        // (not in band mode, where bands may be adjacent), so only while blobs are detected.
+        auto thresholdDepth = [&](const uint16_t* depth, uint16_t thr) {
+            uint16_t hyst = g_blobDetectEnabled.load() ? hysteresisMm : 0;
+            if (planeEnabled) {
+                if (webServer.takePlaneRefitRequest()) plane.requestRefit();
+                if (plane.update(depth)) webServer.updatePlaneStatus(plane.json());
+            }
+            zonesUsed = false;
+            bandsUsed = false;
+            if (planeEnabled && plane.active()) {
+                depthToPlaneThresholdBgr(depth, depthW, depthH, depthBgr.data(),
+                                         plane.nearLimit(), plane.farLimit(), &roi, hyst);
+            } else if (bands.count > 0) {
+                depthToBandsBgr(depth, depthW, depthH, depthBgr.data(), bands, bandMap.data(), &roi);
+                bandsUsed = true;
+            } else if (zones.count > 0) {
+                depthToZoneThresholdBgr(depth, depthW, depthH, depthBgr.data(), thr,
+                                        zones, zoneOcc, &roi, hyst);
+                zonesUsed = true;
+            } else {
+                depthToThresholdBgr(depth, depthW, depthH, depthBgr.data(), thr, &roi, hyst);
+            }
+        };
+        auto zoneIds = [&]() -> const uint8_t* { return zonesUsed ? zones.map.data() : nullptr; };
+        auto bandIds = [&]() -> const uint8_t* { return bandsUsed ? bandMap.data() : nullptr; };
+        // Dilation would merge pixels across band boundaries, so band mode skips it
+        auto dilateIterations = [&]() { return bandsUsed ? 0 : g_dilateIterations.load(); };
+
         // Helper: convert raw depth to millimeters
         auto convertDepthToMm = [&](const uint16_t* raw, int count, float scale) {
             if (scale == 1.0f) {
@@ -548,13 +724,13 @@ int main(int argc, char* argv[]) {
 
             uint16_t thr = g_thresholdEnabled.load()
                 ? static_cast<uint16_t>(g_thresholdMm.load()) : uint16_t(65535);
-            depthToThresholdBgr(depthMm.data(), depthW, depthH, depthBgr.data(), thr);
-            dilateBinaryBgr(depthBgr.data(), depthW, depthH, g_dilateIterations.load());
+            thresholdDepth(depthMm.data(), thr);
+            dilateBinaryBgr(depthBgr.data(), depthW, depthH, dilateIterations(), &roi);
 
             if (g_blobDetectEnabled.load())
                 detectAndDrawBlobs(depthBgr.data(), depthW, depthH,
                                    g_maxBlobPixels.load(), depthMm.data(),
-                                   g_minBlobPixels.load());
+                                   g_minBlobPixels.load(), &roi, zoneIds(), bandIds());
 
             if (showColor && colorW > 0) {
                 auto firstColorRaw = firstFrameSet->getFrame(OB_FRAME_COLOR);
@@ -588,7 +764,62 @@ int main(int argc, char* argv[]) {
             return true;
         };
 
-        BlobTracker tracker;
+        // Track blobs (one tracker per depth band in band mode) and publish them
+        std::vector<std::vector<BlobInfo>> bandBlobs(kMaxBands + 1);
+        std::vector<BlobLayer> layers;
+        TrackHistorySnapshot trackHistory;   // for /tracks, reused across frames
+        auto saveCheckpoint = [&](long long ms) {
+            checkpoint.ms = ms;
+            checkpoint.width = depthW;
+            checkpoint.height = depthH;
+            checkpoint.bands = bandSpec;
+            tracker.saveState(checkpoint.single);
+            checkpoint.bandStates.resize(bandTrackers.size());
+            for (size_t i = 0; i < bandTrackers.size(); i++) bandTrackers[i].saveState(checkpoint.bandStates[i]);
+            if (showWeb && webServer.checkpointWanted()) webServer.updateCheckpoint(checkpoint);
+        };
+        auto trackAndPublish = [&](std::vector<BlobInfo>&& blobs, int frame, long long ms) {
+            if (!bandsUsed) {
+                tracker.update(std::move(blobs), frame, ms);
+                for (auto& t : bandTrackers) t.update({}, frame, ms);
+                if (showWeb) {
+                    const ZoneMap* zm = zonesUsed ? &zones : nullptr;
+                    webServer.pushGestures(tracker.gestureEvents());
+                    if (publishFilter.due(ms, tracker.activeBlobs(), nullptr, zm, &zoneOcc))
+                        webServer.updateBlobs(blobsJson(depthW, depthH, tracker.activeBlobs(), zm, &zoneOcc),
+                                              blobsBinary(depthW, depthH, tracker.activeBlobs()));
+                    if (webServer.tracksWanted()) {
+                        trackHistory.clear(ms);
+                        tracker.snapshotHistory(0, trackHistory);
+                        webServer.updateTracks(trackHistory);
+                    }
+                }
+                saveCheckpoint(ms);
+                return;
+            }
+            tracker.update({}, frame, ms);
+            for (auto& v : bandBlobs) v.clear();
+            for (auto& b : blobs) bandBlobs[b.band].push_back(std::move(b));
+            layers.clear();
+            for (int i = 0; i < bands.count; i++) {
+                bandTrackers[i].update(std::move(bandBlobs[i + 1]), frame, ms);
+                layers.push_back({i + 1, bands.nearMm[i + 1], bands.farMm[i + 1],
+                                  &bandTrackers[i].activeBlobs()});
+            }
+            if (showWeb) {
+                for (int i = 0; i < bands.count; i++) webServer.pushGestures(bandTrackers[i].gestureEvents());
+                const auto& primary = bandTrackers[0].activeBlobs();
+                if (publishFilter.due(ms, primary, &layers))
+                    webServer.updateBlobs(blobsJson(depthW, depthH, primary, nullptr, nullptr, &layers),
+                                          blobsBinary(depthW, depthH, primary, &layers));
+                if (webServer.tracksWanted()) {
+                    trackHistory.clear(ms);
+                    for (int i = 0; i < bands.count; i++) bandTrackers[i].snapshotHistory(i + 1, trackHistory);
+                    webServer.updateTracks(trackHistory);
+                }
+            }
+            saveCheckpoint(ms);
+        };
         int frameCount = 0;
         int fpsFrames = 0;
         auto fpsStart = std::chrono::steady_clock::now();
@@ -604,77 +835,93 @@ int main(int argc, char* argv[]) {
 
             bool gotNewDepth = false;
             bool gotNewColor = false;
+            bool cloudWanted = false;
+
+            // Process color first, so depth registers against this frame's color
+            if (showColor && colorW > 0) {
+                auto colorRaw = frameSet->getFrame(OB_FRAME_COLOR);
+                if (colorRaw) {
+                    gotNewColor = true;
+                    auto colorFrame = colorRaw->as<ob::ColorFrame>();
+                    const auto* rgbData = reinterpret_cast<const uint8_t*>(colorFrame->getData());
+                    packedRgbToPackedBgr(rgbData, colorW, colorH, colorBgr.data());
+                    if (showWeb) webServer.updateColorFrame(colorBgr.data(), colorW, colorH);
+                }
+            }
 
             // Process depth
             auto depthRaw = frameSet->getFrame(OB_FRAME_DEPTH);
             if (depthRaw) {
                 gotNewDepth = true;
+                refreshPipelineSettings();
                 auto depthFrame = depthRaw->as<ob::DepthFrame>();
                 const auto* rawData = reinterpret_cast<const uint16_t*>(depthFrame->getData());
                 convertDepthToMm(rawData, depthW * depthH, depthScale);
 
+                // Color mode: the color seen by every depth pixel, for the window,
+                // the blob colors and /pointcloud
+                if (registration.ready()) {
+                    registration.colorInDepth(depthMm.data(), colorBgr.data(), colorInDepth.data());
+                    if (showWindow) colorView = colorInDepth;
+                }
+
                 uint16_t thr = g_thresholdEnabled.load()
                     ? static_cast<uint16_t>(g_thresholdMm.load()) : uint16_t(65535);
-                depthToThresholdBgr(depthMm.data(), depthW, depthH, depthBgr.data(), thr);
-                dilateBinaryBgr(depthBgr.data(), depthW, depthH, g_dilateIterations.load());
+                thresholdDepth(depthMm.data(), thr);
+                dilateBinaryBgr(depthBgr.data(), depthW, depthH, dilateIterations(), &roi);
+                // The mask for /pointcloud, before blob rectangles are drawn over it
+                cloudWanted = showWeb && webServer.pointCloudWanted();
+                if (cloudWanted) foregroundMask(depthBgr.data(), depthW * depthH, cloudMask.data());
 
                 auto now2 = std::chrono::steady_clock::now();
                 auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
                               now2 - programStart).count();
 
                 if (g_blobDetectEnabled.load()) {
-                    auto blobs = detectAndDrawBlobs(depthBgr.data(), depthW, depthH,
-                                                    g_maxBlobPixels.load(), depthMm.data(),
-                                                    g_minBlobPixels.load());
-
-                    tracker.update(blobs, frameCount, static_cast<long long>(ms));
-
-                    if (showWeb) {
-                        const auto& tracked = tracker.activeBlobs();
-                        std::string json = "{\"w\":" + std::to_string(depthW) +
-                                           ",\"h\":" + std::to_string(depthH) +
-                                           ",\"blobs\":[";
-                        for (size_t i = 0; i < tracked.size(); i++) {
-                            const auto& t = tracked[i];
-                            if (i > 0) json += ",";
-                            json += "{\"id\":" + std::to_string(t.serial) +
-                                    ",\"cx\":" + std::to_string(t.cx) +
-                                    ",\"cy\":" + std::to_string(t.cy) +
-                                    ",\"avg\":" + std::to_string(static_cast<int>(t.avgDepthMm + 0.5f)) +
-                                    ",\"max\":" + std::to_string(static_cast<int>(t.maxDepthMm)) +
-                                    ",\"px\":" + std::to_string(t.pixelCount) + "}";
-                        }
-                        json += "]}";
-                        webServer.updateBlobs(json);
+                    auto blobs = incrementalLabeling
+                        ? tileLabeler.detect(depthBgr.data(), depthW, depthH,
+                                             g_maxBlobPixels.load(), depthMm.data(),
+                                             g_minBlobPixels.load(), &roi, zoneIds(), bandIds(),
+                                             blobLabels, splitStepMm, maxBlobs, nearestFirst)
+                        : detectAndDrawBlobs(depthBgr.data(), depthW, depthH,
+                                             g_maxBlobPixels.load(), depthMm.data(),
+                                             g_minBlobPixels.load(), &roi, zoneIds(), bandIds(),
+                                             &blobLabels, splitStepMm, maxBlobs, nearestFirst);
+                    shape.analyze(blobs, blobLabels, depthW, depthH, depthMm.data());
+                    rays.apply(blobs);
+                    if (registration.ready()) {
+                        registration.sampleBlobColors(blobs, blobLabels, colorInDepth.data());
+                        if (showWindow)
+                            for (const auto& b : blobs) drawBlobRect(colorView.data(), depthW, depthH, b);
                     }
+
+                    countZoneBlobs(zoneOcc, blobs);
+
+                    trackAndPublish(std::move(blobs), frameCount, static_cast<long long>(ms));
                 } else {
-                    tracker.update({}, frameCount, static_cast<long long>(ms));
-                    std::printf("[%6d %7lldms]\n", frameCount, static_cast<long long>(ms));
-                    if (showWeb) {
-                        webServer.updateBlobs("{\"w\":" + std::to_string(depthW) +
-                                              ",\"h\":" + std::to_string(depthH) +
-                                              ",\"blobs\":[]}");
-                    }
+                    trackAndPublish({}, frameCount, static_cast<long long>(ms));
+                    eventLog().push(LogEventType::Frame, LogLevel::Debug, frameCount, static_cast<long long>(ms));
                 }
 
                 if (showWeb) webServer.updateDepthFrame(depthBgr.data(), depthW, depthH);
             }
 
-            // Process color
-            if (showColor && colorW > 0) {
-                auto colorRaw = frameSet->getFrame(OB_FRAME_COLOR);
-                if (colorRaw) {
-                    gotNewColor = true;
-                    auto colorFrame = colorRaw->as<ob::ColorFrame>();
-                    const auto* rgbData = reinterpret_cast<const uint8_t*>(colorFrame->getData());
-                    packedRgbToPackedBgr(rgbData, colorW, colorH, colorBgr.data());
-                    if (showWeb) webServer.updateColorFrame(colorBgr.data(), colorW, colorH);
-                }
+            // Point cloud, with this frame's color as seen from each depth pixel
+            if (gotNewDepth && cloudWanted) {
+                const uint8_t* alignedColor = registration.ready() ? colorInDepth.data() : nullptr;
+                resolveForegroundMask(depthBgr.data(), depthW * depthH, cloudMask.data());
+                webServer.updatePointCloud(depthMm.data(), cloudMask.data(), depthW, depthH,
+                                           rays.intrinsics(), alignedColor);
             }
 
             if (gotNewDepth || gotNewColor) {
                 if (showWindow) {
-                    if (showColor && colorW > 0)
+                    // Registered color (aligned with the mask, blob boxes drawn on
+                    // it) when there is a calibration, else the raw color frame
+                    if (registration.ready())
+                        viewer.updateSideBySide(colorView.data(), depthW, depthH,
+                                                depthBgr.data(), depthW, depthH);
+                    else if (showColor && colorW > 0)
                         viewer.updateSideBySide(colorBgr.data(), colorW, colorH,
                                                 depthBgr.data(), depthW, depthH);
                     else
@@ -715,5 +962,6 @@ int main(int argc, char* argv[]) {
 
     if (showWeb) webServer.stop();
     if (showWindow) viewer.shutdown();
+    eventLog().stop();
     return 0;
 }
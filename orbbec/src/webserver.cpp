@@ -1,5 +1,6 @@
 #include "webserver.hpp"
 
+#include <chrono>
 #include <cstdio>
 #include <cstring>
 #include <fstream>
@@ -11,25 +12,10 @@
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 #include "stb_image_write.h"
 
-// ---- JPEG encoding for MJPEG streaming ----
-static void jpegWriteFunc(void* context, void* data, int size) {
-    auto* buf = static_cast<std::vector<uint8_t>*>(context);
-    auto* bytes = static_cast<const uint8_t*>(data);
-    buf->insert(buf->end(), bytes, bytes + size);
-}
-
-static std::vector<uint8_t> encodeJpeg(const uint8_t* bgr, int width, int height, int quality = 80) {
-    std::vector<uint8_t> rgb(static_cast<size_t>(width) * height * 3);
-    for (int i = 0; i < width * height; i++) {
-        rgb[i * 3 + 0] = bgr[i * 3 + 2];  // R <- B
-        rgb[i * 3 + 1] = bgr[i * 3 + 1];  // G
-        rgb[i * 3 + 2] = bgr[i * 3 + 0];  // B <- R
-    }
-    std::vector<uint8_t> jpeg;
-    jpeg.reserve(static_cast<size_t>(width) * height / 4);
-    stbi_write_jpg_to_func(jpegWriteFunc, &jpeg, width, height, 3, rgb.data(), quality);
-    return jpeg;
-}
+#include "blobjson.hpp"
+#include "pointcloud.hpp"
+#include "webserver_common.hpp"
+#include "web_ui_shared.hpp"
 
 // ---- HTML page (split into segments to stay under MSVC 16KB raw string limit) ----
 
@@ -87,6 +73,11 @@ static const std::string kHtmlHead = R"HTML(<!DOCTYPE html>
   .help-box button:hover { background: #666; }
   h2 { font-size: 15px; margin: 12px 0 4px; color: #8cf; width: 100%; }
   .unsupported { display: none !important; }
+  input[type=text] { background: #1a1a2e; color: #eee; border: 1px solid #444; border-radius: 4px;
+                     padding: 4px 8px; font-size: 13px; font-family: monospace; }
+  .btn { background: #444; color: #eee; border: none; border-radius: 4px;
+         padding: 6px 12px; cursor: pointer; font-size: 13px; }
+  .btn:hover { background: #666; }
 </style>
 </head>
 <body>
@@ -113,6 +104,10 @@ static const std::string kHtmlControls1 = R"HTML(
     <input id="threshSlider" class="slider" type="range" min="200" max="1200" step="10" value="550">
   </label>
   <span id="threshVal" class="val">550 mm</span>
+  <label>Grow<span class="help-btn" onclick="showHelp('Grow (Hysteresis)','Second, weaker threshold this many mm beyond the main one. Pixels in that band join a blob only when connected to pixels closer than the threshold, so blob edges stop flickering when a hand hovers near the threshold. 0 = off.')">?</span>:
+    <input id="weakSlider" class="slider" type="range" min="0" max="300" step="10" value="0" style="width:100px">
+  </label>
+  <span id="weakVal" class="val">+0 mm</span>
   <label>Dilate<span class="help-btn" onclick="showHelp('Dilate','Expands black regions by N pixels. Helps connect nearby blobs.')">?</span>:
     <input id="dilateSlider" class="slider" type="range" min="0" max="10" step="1" value="0" style="width:100px">
   </label>
@@ -480,6 +475,8 @@ static const std::string kHtmlScript1 = R"HTML(
   const threshToggle = document.getElementById('threshToggle');
   const threshSlider = document.getElementById('threshSlider');
   const threshVal = document.getElementById('threshVal');
+  const weakSlider = document.getElementById('weakSlider');
+  const weakVal = document.getElementById('weakVal');
   const dilateSlider = document.getElementById('dilateSlider');
   const dilateVal = document.getElementById('dilateVal');
   const blobToggle = document.getElementById('blobToggle');
@@ -603,7 +600,7 @@ static const std::string kHtmlScript1 = R"HTML(
     wholetone:   [0,2,4,6,8,10]
   };
 
-  function startTone(freq, blobId, cx, cy) {
+  function startTone(freq, blobId, pos) {
     if (!audioCtx) audioCtx = new AudioContext();
     if (audioCtx.state === 'suspended') audioCtx.resume();
     const osc = audioCtx.createOscillator();
@@ -615,7 +612,7 @@ static const std::string kHtmlScript1 = R"HTML(
     g.gain.exponentialRampToValueAtTime(0.001, audioCtx.currentTime + decay);
     osc.connect(g).connect(audioCtx.destination);
     osc.start();
-    activeTones.set(blobId, {osc: osc, gain: g, startTime: audioCtx.currentTime, cx: cx, cy: cy});
+    activeTones.set(blobId, {osc: osc, gain: g, startTime: audioCtx.currentTime, pos: pos});
   }
 
   function cancelPending(blobId) {
@@ -678,18 +675,17 @@ static const std::string kHtmlScript1 = R"HTML(
       const delayMs = Math.max(0, (nextBeat - now) * 1000);
       cancelPending(b.id);
       const fq = freq;
-      const cx = b.cx;
-      const cy = b.cy;
+      const pos = b.xyz;
       const bid = b.id;
       console.log(label + ' id=' + bid + ' Mode=' + currentMode + ' raw=' + rawFreq.toFixed(2) + ' played=' + fq.toFixed(2) + info + ' qDelay=' + delayMs.toFixed(0) + 'ms');
       const tid = setTimeout(function() {
         pendingTones.delete(bid);
-        startTone(fq, bid, cx, cy);
+        startTone(fq, bid, pos);
       }, delayMs);
       pendingTones.set(b.id, tid);
     } else {
       console.log(label + ' id=' + b.id + ' Mode=' + currentMode + ' raw=' + rawFreq.toFixed(2) + ' played=' + freq.toFixed(2) + info);
-      startTone(freq, b.id, b.cx, b.cy);
+      startTone(freq, b.id, b.xyz);
     }
   }
 
@@ -702,12 +698,12 @@ static const std::string kHtmlScript1 = R"HTML(
       const existing = activeTones.get(b.id);
       if (!existing && !pendingTones.has(b.id)) {
         triggerTone(b, j, 'START');
-      } else if (existing && moveThresh > 0) {
-        const dx = b.cx - existing.cx;
-        const dy = b.cy - existing.cy;
-        const pxDist = Math.sqrt(dx * dx + dy * dy);
-        const depth = b.avg > 0 ? b.avg : 500;
-        const mmDist = pxDist * depth / 640;
+      } else if (existing && moveThresh > 0 && b.xyz[2] > 0 && existing.pos[2] > 0) {
+        // Camera-space distance (mm) from where the tone started
+        const dx = b.xyz[0] - existing.pos[0];
+        const dy = b.xyz[1] - existing.pos[1];
+        const dz = b.xyz[2] - existing.pos[2];
+        const mmDist = Math.sqrt(dx * dx + dy * dy + dz * dz);
         if (mmDist > moveThresh) {
           stopTone(b.id);
           triggerTone(b, j, 'MOVE');
@@ -751,6 +747,18 @@ static const std::string kHtmlScript1 = R"HTML(
         dotsCtx.arc(b.cx, b.cy, r, 0, 2 * Math.PI);
         dotsCtx.fillStyle = '#0f0';
         dotsCtx.fill();
+        if (b.contour && b.contour.length >= 6) {
+          dotsCtx.beginPath();
+          dotsCtx.moveTo(b.contour[0], b.contour[1]);
+          for (let i = 2; i < b.contour.length; i += 2) dotsCtx.lineTo(b.contour[i], b.contour[i + 1]);
+          dotsCtx.closePath();
+          dotsCtx.strokeStyle = '#0f0';
+          dotsCtx.stroke();
+        }
+        if (b.tips) {
+          dotsCtx.fillStyle = '#f0f';
+          for (const t of b.tips) dotsCtx.fillRect(t.x - 3, t.y - 3, 6, 6);
+        }
       }
     }
   }
@@ -767,6 +775,7 @@ static const std::string kHtmlScript1 = R"HTML(
     stopAllTones();
     evtSource = new EventSource('/events');
     evtSource.onmessage = onSseMessage;
+    evtSource.addEventListener('gesture', onGesture);
   }
 
   function stopDotsStream() {
@@ -818,6 +827,10 @@ static const std::string kHtmlScript1 = R"HTML(
     threshVal.textContent = threshSlider.value + ' mm';
     fetch('/threshold?value=' + threshSlider.value);
   });
+  weakSlider.addEventListener('input', function() {
+    weakVal.textContent = '+' + weakSlider.value + ' mm';
+    fetch('/threshold?weak=' + weakSlider.value);
+  });
   dilateSlider.addEventListener('input', function() {
     dilateVal.textContent = dilateSlider.value;
     fetch('/threshold?dilate=' + dilateSlider.value);
@@ -1056,6 +1069,8 @@ static const std::string kHtmlScript5 = R"HTML(
     threshSlider.value = j.threshold;
     threshSlider.disabled = !j.enabled;
     threshVal.textContent = j.threshold + ' mm';
+    weakSlider.value = j.weak;
+    weakVal.textContent = '+' + j.weak + ' mm';
     dilateSlider.value = j.dilate;
     dilateVal.textContent = j.dilate;
   });
@@ -1275,6 +1290,9 @@ void WebServer::stop() {
     blobsCv_.notify_all();
     depthCv_.notify_all();
     colorCv_.notify_all();
+    cloudCv_.notify_all();
+    tracksCv_.notify_all();
+    checkpointCv_.notify_all();
     if (thread_.joinable()) thread_.join();
 }
 
@@ -1304,15 +1322,88 @@ void WebServer::updateDepthFrame(const uint8_t* bgr, int width, int height) {
     depthCv_.notify_all();
 }
 
-void WebServer::updateBlobs(const std::string& json) {
+void WebServer::updateBlobs(const std::string& json, const std::string& binary) {
     {
         std::lock_guard<std::mutex> lock(frameMtx_);
         blobsJson_ = json;
+        blobsBin_ = binary;
         blobsSeq_++;
     }
     blobsCv_.notify_all();
 }
 
+static long long steadyMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool WebServer::pointCloudWanted() const {
+    return steadyMs() - cloudPollMs_.load() < 2000;
+}
+
+void WebServer::updatePointCloud(const uint16_t* depthMm, const uint8_t* mask, int width,
+                                 int height, const CameraIntrinsics& k, const uint8_t* colorBgr) {
+    {
+        std::lock_guard<std::mutex> lock(frameMtx_);
+        size_t n = static_cast<size_t>(width) * height;
+        cloudDepth_.assign(depthMm, depthMm + n);
+        cloudMask_.resize(n);
+        for (size_t i = 0; i < n; i++) cloudMask_[i] = mask[i] != 0;
+        if (colorBgr) cloudColor_.assign(colorBgr, colorBgr + n * 3);
+        else cloudColor_.clear();
+        cloudIntr_ = k;
+        cloudSeq_++;
+    }
+    cloudCv_.notify_all();
+}
+
+void WebServer::pushGestures(const std::vector<GestureEvent>& events) {
+    if (events.empty()) return;
+    {
+        std::lock_guard<std::mutex> lock(frameMtx_);
+        for (const auto& e : events) gestureRing_[gestureSeq_++ % kGestureRing] = e;
+    }
+    blobsCv_.notify_all();
+}
+
+bool WebServer::tracksWanted() const {
+    return steadyMs() - tracksPollMs_.load() < 2000;
+}
+
+void WebServer::updateTracks(const TrackHistorySnapshot& snap) {
+    {
+        std::lock_guard<std::mutex> lock(frameMtx_);
+        tracks_.ms = snap.ms;
+        tracks_.tracks = snap.tracks;
+        tracks_.samples = snap.samples;
+        tracksSeq_++;
+    }
+    tracksCv_.notify_all();
+}
+
+bool WebServer::checkpointWanted() const {
+    return steadyMs() - checkpointPollMs_.load() < 2000;
+}
+
+void WebServer::updateCheckpoint(const TrackerCheckpoint& cp) {
+    {
+        std::lock_guard<std::mutex> lock(frameMtx_);
+        checkpoint_ = cp;
+        checkpointSeq_++;
+    }
+    checkpointCv_.notify_all();
+}
+
+PipelineSettings WebServer::getPipelineSettings() {
+    std::lock_guard<std::mutex> lock(pipelineMtx_);
+    return pipeline_;
+}
+
+void WebServer::updatePlaneStatus(const std::string& json) {
+    std::lock_guard<std::mutex> lock(pipelineMtx_);
+    planeStatus_ = json;
+}
+
 PostProcSettings WebServer::getPostProcSettings() {
     std::lock_guard<std::mutex> lock(postProcMtx_);
     return postProc_;
@@ -1345,6 +1436,7 @@ void WebServer::saveSettings() {
     DeviceSettings ds;
     std::string sScale, sQuantize;
     { std::lock_guard<std::mutex> lock(devSettingsMtx_); ds = devSettings_; sScale = soundScale_; sQuantize = soundQuantize_; }
+    PipelineSettings ps = getPipelineSettings();
 
     std::string json =
         std::string("{\n"
@@ -1400,7 +1492,9 @@ void WebServer::saveSettings() {
         "  \"soundMoveThresh\": " + std::to_string(soundMoveThresh_.load()) + ",\n"
         "  \"soundQuantize\": \"" + sQuantize + "\",\n"
         "  \"soundTempo\": " + std::to_string(soundTempo_.load()) + ",\n"
-        "  \"showDepth\": " + (showDepth_.load() ? "true" : "false") + "\n"
+        "  \"showDepth\": " + (showDepth_.load() ? "true" : "false") + ",\n"
+        // Pipeline settings (ROI etc.)
+        + savePipelineSettingsJson(ps) + "\n"
         "}\n";
 
     std::ofstream tmp("settings.json.tmp");
@@ -1411,54 +1505,6 @@ void WebServer::saveSettings() {
     std::rename("settings.json.tmp", "settings.json");
 }
 
-// Simple helper: find "key": in text and extract the value (int or bool)
-static bool jsonInt(const std::string& text, const std::string& key, int& out) {
-    std::string needle = "\"" + key + "\":";
-    auto pos = text.find(needle);
-    if (pos == std::string::npos) return false;
-    pos += needle.size();
-    while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t')) pos++;
-    if (pos >= text.size()) return false;
-    bool negative = false;
-    if (text[pos] == '-') { negative = true; pos++; }
-    if (pos >= text.size() || !std::isdigit(static_cast<unsigned char>(text[pos]))) return false;
-    int val = 0;
-    while (pos < text.size() && std::isdigit(static_cast<unsigned char>(text[pos]))) {
-        val = val * 10 + (text[pos] - '0');
-        pos++;
-    }
-    out = negative ? -val : val;
-    return true;
-}
-
-static bool jsonBool(const std::string& text, const std::string& key, bool& out) {
-    std::string needle = "\"" + key + "\":";
-    auto pos = text.find(needle);
-    if (pos == std::string::npos) return false;
-    pos += needle.size();
-    while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t')) pos++;
-    if (pos >= text.size()) return false;
-    if (text.compare(pos, 4, "true") == 0) { out = true; return true; }
-    if (text.compare(pos, 5, "false") == 0) { out = false; return true; }
-    return false;
-}
-
-static bool jsonString(const std::string& text, const std::string& key, std::string& out) {
-    std::string needle = "\"" + key + "\":";
-    auto pos = text.find(needle);
-    if (pos == std::string::npos) return false;
-    pos += needle.size();
-    while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t')) pos++;
-    if (pos >= text.size() || text[pos] != '"') return false;
-    pos++; // skip opening quote
-    std::string result;
-    while (pos < text.size() && text[pos] != '"') {
-        result += text[pos++];
-    }
-    out = result;
-    return true;
-}
-
 void WebServer::loadSettings() {
     std::ifstream file("settings.json");
     if (!file) return;
@@ -1530,6 +1576,11 @@ void WebServer::loadSettings() {
     if (jsonInt(text, "soundTempo", iv)) soundTempo_.store(iv);
     if (jsonBool(text, "showDepth", bv)) showDepth_.store(bv);
 
+    {
+        std::lock_guard<std::mutex> lock(pipelineMtx_);
+        loadPipelineSettings(text, pipeline_);
+    }
+
     std::cout << "Loaded settings from settings.json" << std::endl;
 }
 
@@ -1572,11 +1623,13 @@ void WebServer::run() {
     httplib::Server svr;
 
     // Build full HTML page
-    std::string fullHtml = kHtmlHead + kHtmlControls1 + kHtmlControls2 +
+    std::string fullHtml = kHtmlHead + kHtmlControls1 + kSharedRegionControls + kSharedShapeControls +
+                           kHtmlControls2 +
                            kHtmlControls3 + kHtmlControls4 + kHtmlControls5 +
                            kHtmlControls6 + kHtmlImages +
                            kHtmlScript1 + kHtmlScript2 + kHtmlScript3 +
-                           kHtmlScript4 + kHtmlScript5 + kHtmlScript6;
+                           kHtmlScript4 + kHtmlScript5 + kSharedRegionJs + kSharedShapeJs +
+                           kHtmlScript6;
 
     // GET / — HTML page (hide color image if color stream is disabled)
     svr.Get("/", [this, &fullHtml](const httplib::Request&, httplib::Response& res) {
@@ -1829,14 +1882,29 @@ void WebServer::run() {
             dilateIterations_.store(val);
             changed = true;
         }
+        if (req.has_param("weak")) {
+            int val = std::stoi(req.get_param_value("weak"));
+            if (val < 0) val = 0;
+            if (val > 300) val = 300;
+            {
+                std::lock_guard<std::mutex> lock(pipelineMtx_);
+                pipeline_.hysteresisMm = val;
+            }
+            pipelineSeq_++;
+            changed = true;
+        }
         if (changed) saveSettings();
         res.set_content("{\"threshold\":" + std::to_string(thresholdMm_.load()) +
                         ",\"enabled\":" + (thresholdEnabled_.load() ? "true" : "false") +
-                        ",\"dilate\":" + std::to_string(dilateIterations_.load()) + "}",
+                        ",\"dilate\":" + std::to_string(dilateIterations_.load()) +
+                        ",\"weak\":" + std::to_string(getPipelineSettings().hysteresisMm) + "}",
                         "application/json");
     });
 
-    // GET /blobdetect — get or set blob detection settings
+    // GET /blobdetect — get or set blob detection settings. ?delta=1 publishes
+    // blobs only when something changed beyond ?deltapx / ?deltamm (tracks,
+    // tips, zone occupancy; see blobpublish.hpp) plus every ?keyframe ms; each
+    // published frame is still a full snapshot of all blobs, not the changes.
     svr.Get("/blobdetect", [this](const httplib::Request& req, httplib::Response& res) {
         bool changed = false;
         if (req.has_param("enabled")) {
@@ -1857,16 +1925,298 @@ void WebServer::run() {
             minBlobPixels_.store(val);
             changed = true;
         }
+        if (req.has_param("split")) {
+            int val = std::stoi(req.get_param_value("split"));
+            if (val < 0) val = 0;
+            if (val > 500) val = 500;
+            {
+                std::lock_guard<std::mutex> lock(pipelineMtx_);
+                pipeline_.splitStepMm = val;
+            }
+            pipelineSeq_++;
+            changed = true;
+        }
+        if (req.has_param("topk") || req.has_param("rank")) {
+            std::lock_guard<std::mutex> lock(pipelineMtx_);
+            if (req.has_param("topk")) {
+                int val = std::stoi(req.get_param_value("topk"));
+                if (val < 0) val = 0;
+                if (val > 64) val = 64;
+                pipeline_.maxBlobs = val;
+            }
+            if (req.has_param("rank")) pipeline_.nearestFirst = req.get_param_value("rank") == "nearest";
+            pipelineSeq_++;
+            changed = true;
+        }
+        if (req.has_param("incremental")) {
+            {
+                std::lock_guard<std::mutex> lock(pipelineMtx_);
+                pipeline_.incrementalLabeling = req.get_param_value("incremental") == "1";
+            }
+            pipelineSeq_++;
+            changed = true;
+        }
+        if (req.has_param("assign")) {
+            {
+                std::lock_guard<std::mutex> lock(pipelineMtx_);
+                pipeline_.optimalAssignment = req.get_param_value("assign") == "optimal";
+            }
+            pipelineSeq_++;
+            changed = true;
+        }
+        if (req.has_param("confirm") || req.has_param("coast")) {
+            std::lock_guard<std::mutex> lock(pipelineMtx_);
+            if (req.has_param("confirm")) {
+                int val = std::stoi(req.get_param_value("confirm"));
+                if (val < 1) val = 1;
+                if (val > 30) val = 30;
+                pipeline_.confirmFrames = val;
+            }
+            if (req.has_param("coast")) {
+                int val = std::stoi(req.get_param_value("coast"));
+                if (val < 0) val = 0;
+                if (val > 30) val = 30;
+                pipeline_.coastFrames = val;
+            }
+            pipelineSeq_++;
+            changed = true;
+        }
+        if (req.has_param("gate")) {
+            {
+                std::lock_guard<std::mutex> lock(pipelineMtx_);
+                int val = std::stoi(req.get_param_value("gate"));
+                if (val < 0) val = 0;
+                if (val > 500) val = 500;
+                pipeline_.matchGateMm = val;
+            }
+            pipelineSeq_++;
+            changed = true;
+        }
+        if (req.has_param("delta") || req.has_param("deltapx") || req.has_param("deltamm") ||
+            req.has_param("keyframe")) {
+            std::lock_guard<std::mutex> lock(pipelineMtx_);
+            if (req.has_param("delta")) pipeline_.deltaPublish = req.get_param_value("delta") == "1";
+            if (req.has_param("deltapx")) {
+                int val = std::stoi(req.get_param_value("deltapx"));
+                if (val < 0) val = 0;
+                if (val > 100) val = 100;
+                pipeline_.deltaPx = val;
+            }
+            if (req.has_param("deltamm")) {
+                int val = std::stoi(req.get_param_value("deltamm"));
+                if (val < 0) val = 0;
+                if (val > 500) val = 500;
+                pipeline_.deltaMm = val;
+            }
+            if (req.has_param("keyframe")) {
+                int val = std::stoi(req.get_param_value("keyframe"));
+                if (val < 100) val = 100;
+                if (val > 10000) val = 10000;
+                pipeline_.keyframeMs = val;
+            }
+            pipelineSeq_++;
+            changed = true;
+        }
         if (changed) saveSettings();
         bool enabled = blobDetectEnabled_.load();
         int maxsz = maxBlobPixels_.load();
         int minsz = minBlobPixels_.load();
+        auto ps = getPipelineSettings();
         res.set_content("{\"enabled\":" + std::string(enabled ? "true" : "false") +
                         ",\"maxsize\":" + std::to_string(maxsz) +
-                        ",\"minsize\":" + std::to_string(minsz) + "}",
+                        ",\"minsize\":" + std::to_string(minsz) +
+                        ",\"split\":" + std::to_string(ps.splitStepMm) +
+                        ",\"topk\":" + std::to_string(ps.maxBlobs) +
+                        ",\"rank\":\"" + (ps.nearestFirst ? "nearest" : "largest") + "\"" +
+                        ",\"incremental\":" + (ps.incrementalLabeling ? "true" : "false") +
+                        ",\"assign\":\"" + (ps.optimalAssignment ? "optimal" : "greedy") + "\"" +
+                        ",\"confirm\":" + std::to_string(ps.confirmFrames) +
+                        ",\"coast\":" + std::to_string(ps.coastFrames) +
+                        ",\"gate\":" + std::to_string(ps.matchGateMm) +
+                        ",\"delta\":" + (ps.deltaPublish ? "true" : "false") +
+                        ",\"deltapx\":" + std::to_string(ps.deltaPx) +
+                        ",\"deltamm\":" + std::to_string(ps.deltaMm) +
+                        ",\"keyframe\":" + std::to_string(ps.keyframeMs) + "}",
                         "application/json");
     });
 
+    // GET /roi — get or set region of interest (crop rectangle + exclusion polygons)
+    svr.Get("/roi", [this](const httplib::Request& req, httplib::Response& res) {
+        bool changed = false;
+        {
+            std::lock_guard<std::mutex> lock(pipelineMtx_);
+            if (req.has_param("enabled")) {
+                pipeline_.roiEnabled = req.get_param_value("enabled") == "1";
+                changed = true;
+            }
+            if (req.has_param("crop")) {
+                pipeline_.roiCrop = sanitizeRoiSpec(req.get_param_value("crop"));
+                changed = true;
+            }
+            if (req.has_param("exclude")) {
+                pipeline_.roiExclude = sanitizeRoiSpec(req.get_param_value("exclude"));
+                changed = true;
+            }
+        }
+        if (changed) {
+            pipelineSeq_++;
+            saveSettings();
+        }
+        res.set_content(roiSettingsJson(getPipelineSettings()), "application/json");
+    });
+
+    // GET /zones — get or set multi-zone segmentation (per-zone near/far bands)
+    svr.Get("/zones", [this](const httplib::Request& req, httplib::Response& res) {
+        bool changed = false;
+        {
+            std::lock_guard<std::mutex> lock(pipelineMtx_);
+            if (req.has_param("enabled")) {
+                pipeline_.zonesEnabled = req.get_param_value("enabled") == "1";
+                changed = true;
+            }
+            if (req.has_param("spec")) {
+                pipeline_.zones = sanitizeZoneSpec(req.get_param_value("spec"));
+                changed = true;
+            }
+        }
+        if (changed) {
+            pipelineSeq_++;
+            saveSettings();
+        }
+        res.set_content(zoneSettingsJson(getPipelineSettings()), "application/json");
+    });
+
+    // GET /bands — get or set depth bands (independent blob layers per band)
+    svr.Get("/bands", [this](const httplib::Request& req, httplib::Response& res) {
+        bool changed = false;
+        {
+            std::lock_guard<std::mutex> lock(pipelineMtx_);
+            if (req.has_param("enabled")) {
+                pipeline_.bandsEnabled = req.get_param_value("enabled") == "1";
+                changed = true;
+            }
+            if (req.has_param("spec")) {
+                pipeline_.bands = sanitizeBandSpec(req.get_param_value("spec"));
+                changed = true;
+            }
+        }
+        if (changed) {
+            pipelineSeq_++;
+            saveSettings();
+        }
+        res.set_content(bandSettingsJson(getPipelineSettings()), "application/json");
+    });
+
+    // GET /contours — get or set blob outline tracing (Douglas-Peucker epsilon in px,
+    // vertex limit per outline) and the number of extremities (fingertips) reported per blob
+    svr.Get("/contours", [this](const httplib::Request& req, httplib::Response& res) {
+        bool changed = false;
+        {
+            std::lock_guard<std::mutex> lock(pipelineMtx_);
+            if (req.has_param("enabled")) {
+                pipeline_.contoursEnabled = req.get_param_value("enabled") == "1";
+                changed = true;
+            }
+            if (req.has_param("epsilon")) {
+                int val = std::stoi(req.get_param_value("epsilon"));
+                if (val < 1) val = 1;
+                if (val > 20) val = 20;
+                pipeline_.contourEpsilonPx = val;
+                changed = true;
+            }
+            if (req.has_param("vertices")) {
+                int val = std::stoi(req.get_param_value("vertices"));
+                if (val < 0) val = 0;
+                if (val > 0 && val < 8) val = 8;
+                if (val > 1024) val = 1024;
+                pipeline_.contourMaxVertices = val;
+                changed = true;
+            }
+            if (req.has_param("tips")) {
+                int val = std::stoi(req.get_param_value("tips"));
+                if (val < 0) val = 0;
+                if (val > 10) val = 10;
+                pipeline_.maxTips = val;
+                changed = true;
+            }
+        }
+        if (changed) {
+            pipelineSeq_++;
+            saveSettings();
+        }
+        res.set_content(contourSettingsJson(getPipelineSettings()), "application/json");
+    });
+
+    // GET /gestures — gesture recognizer settings (see gestures.hpp); events go
+    // out on /events ("gesture") and /gestures.bin
+    svr.Get("/gestures", [this](const httplib::Request& req, httplib::Response& res) {
+        bool changed = false;
+        auto intParam = [&](const char* name, int lo, int hi, int& field) {
+            if (!req.has_param(name)) return;
+            int val = std::stoi(req.get_param_value(name));
+            if (val < lo) val = lo;
+            if (val > hi) val = hi;
+            field = val;
+            changed = true;
+        };
+        {
+            std::lock_guard<std::mutex> lock(pipelineMtx_);
+            if (req.has_param("enabled")) {
+                pipeline_.gesturesEnabled = req.get_param_value("enabled") == "1";
+                changed = true;
+            }
+            intParam("tap", 50, 2000, pipeline_.tapMaxMs);
+            intParam("hold", 100, 5000, pipeline_.holdMs);
+            intParam("still", 1, 200, pipeline_.stillRadiusPx);
+            intParam("speed", 50, 10000, pipeline_.swipeSpeed);
+            intParam("swipe", 5, 1000, pipeline_.swipeMinPx);
+            intParam("pinch", 1, 100, pipeline_.pinchStepPct);
+        }
+        if (changed) {
+            pipelineSeq_++;
+            saveSettings();
+        }
+        res.set_content(gestureSettingsJson(getPipelineSettings()), "application/json");
+    });
+
+    // GET /plane — surface plane segmentation settings and fitted plane; refit=1 forces a refit
+    svr.Get("/plane", [this](const httplib::Request& req, httplib::Response& res) {
+        bool changed = false;
+        std::string body;
+        {
+            std::lock_guard<std::mutex> lock(pipelineMtx_);
+            if (req.has_param("enabled")) {
+                pipeline_.planeEnabled = req.get_param_value("enabled") == "1";
+                changed = true;
+            }
+            if (req.has_param("min")) {
+                int val = std::stoi(req.get_param_value("min"));
+                if (val < 0) val = 0;
+                if (val > 500) val = 500;
+                pipeline_.planeMinMm = val;
+                changed = true;
+            }
+            if (req.has_param("max")) {
+                int val = std::stoi(req.get_param_value("max"));
+                if (val < 10) val = 10;
+                if (val > 2000) val = 2000;
+                pipeline_.planeMaxMm = val;
+                changed = true;
+            }
+            if (req.has_param("intrinsics")) {
+                pipeline_.intrinsics = sanitizeRoiSpec(req.get_param_value("intrinsics"));
+                changed = true;
+            }
+            body = planeSettingsJson(pipeline_, planeStatus_);
+        }
+        if (req.has_param("refit")) planeRefit_.store(true);
+        if (changed) {
+            pipelineSeq_++;
+            saveSettings();
+        }
+        res.set_content(body, "application/json");
+    });
+
     // GET /cameraconfig — get or set camera configuration (resolution, fps)
     svr.Get("/cameraconfig", [this](const httplib::Request& req, httplib::Response& res) {
         bool changed = false;
@@ -2137,13 +2487,180 @@ void WebServer::run() {
         res.set_content(buf, "application/json");
     });
 
+    // GET /pointcloud — deprojected depth frame (see pointcloud.hpp); long-polls like
+    // depth.raw. ?stride=N decimates, ?crop=x0,y0,x1,y1 (normalized) crops, ?fg=1
+    // keeps foreground pixels only, ?color=1 adds RGB, ?format=ply for binary PLY.
+    svr.Get("/pointcloud", [this](const httplib::Request& req, httplib::Response& res) {
+        res.set_header("Cache-Control", "no-cache");
+        res.set_header("Access-Control-Allow-Origin", "*");
+        cloudPollMs_ = steadyMs();
+        int clientSeq = 0;
+        if (req.has_param("seq")) clientSeq = std::stoi(req.get_param_value("seq"));
+        PointCloudOptions opt;
+        if (req.has_param("stride")) opt.stride = std::stoi(req.get_param_value("stride"));
+        if (opt.stride < 1) opt.stride = 1;
+        if (opt.stride > 16) opt.stride = 16;
+        opt.foregroundOnly = req.has_param("fg") && req.get_param_value("fg") == "1";
+        opt.color = req.has_param("color") && req.get_param_value("color") == "1";
+        opt.ply = req.has_param("format") && req.get_param_value("format") == "ply";
+        float crop[4] = {0.0f, 0.0f, 1.0f, 1.0f};
+        opt.crop = req.has_param("crop") && parseRoiCrop(req.get_param_value("crop"), crop);
+        {
+            std::unique_lock<std::mutex> lock(frameMtx_);
+            cloudCv_.wait_for(lock, std::chrono::seconds(2),
+                [&] { return cloudSeq_ > clientSeq || !running_; });
+        }
+
+        // Per-connection buffers: a polling client reuses them frame after frame
+        thread_local std::vector<uint16_t> depth;
+        thread_local std::vector<uint8_t> mask;
+        thread_local std::vector<uint8_t> colorBgr;
+        thread_local DepthRays rays;
+        thread_local std::string body;
+        CameraIntrinsics k;
+        PointCloudColor color;
+        int seq;
+        {
+            std::lock_guard<std::mutex> lock(frameMtx_);
+            if (cloudDepth_.empty()) { res.status = 204; return; }
+            depth = cloudDepth_;
+            if (opt.foregroundOnly) mask = cloudMask_;
+            k = cloudIntr_;
+            seq = cloudSeq_;
+            if (opt.color && !cloudColor_.empty()) {
+                colorBgr = cloudColor_;
+                color.width = k.width;
+                color.height = k.height;
+            } else if (opt.color && !colorBgr_.empty()) {
+                colorBgr = colorBgr_;
+                color.width = colorW_;
+                color.height = colorH_;
+            }
+        }
+        if (color.width > 0) {
+            color.bgr = colorBgr.data();
+            color.depthW = k.width;
+            color.depthH = k.height;
+        }
+        rays.configure(k);
+        // Rounded like compileRoiSpans; buildPointCloud orders the corners
+        opt.x0 = static_cast<int>(crop[0] * k.width + 0.5f);
+        opt.y0 = static_cast<int>(crop[1] * k.height + 0.5f);
+        opt.x1 = static_cast<int>(crop[2] * k.width + 0.5f);
+        opt.y1 = static_cast<int>(crop[3] * k.height + 0.5f);
+        buildPointCloud(depth.data(), opt.foregroundOnly ? mask.data() : nullptr, k.width, k.height,
+                        rays, opt, color, static_cast<uint32_t>(seq), body);
+        res.set_header("X-Frame-Seq", std::to_string(seq));
+        res.set_content(body, opt.ply ? "application/x-ply" : "application/octet-stream");
+    });
+
+    // GET /tracks — recent path of every tracked blob (see tracksJson). The
+    // histories are only pushed while someone asks, so the first request waits
+    // for the next frame. ?id=N for one track, ?band=N for one layer, ?n=N for
+    // the newest N samples per track.
+    svr.Get("/tracks", [this](const httplib::Request& req, httplib::Response& res) {
+        res.set_header("Cache-Control", "no-cache");
+        res.set_header("Access-Control-Allow-Origin", "*");
+        bool fresh = tracksWanted();
+        tracksPollMs_ = steadyMs();
+        int id = -1, band = -1, n = 0;
+        if (req.has_param("id")) id = std::stoi(req.get_param_value("id"));
+        if (req.has_param("band")) band = std::stoi(req.get_param_value("band"));
+        if (req.has_param("n")) n = std::stoi(req.get_param_value("n"));
+        thread_local TrackHistorySnapshot snap;
+        {
+            std::unique_lock<std::mutex> lock(frameMtx_);
+            if (!fresh) {
+                int seq = tracksSeq_;
+                tracksCv_.wait_for(lock, std::chrono::milliseconds(500),
+                    [&] { return tracksSeq_ != seq || !running_; });
+            }
+            if (tracksSeq_ == 0) { res.status = 204; return; }
+            snap.ms = tracks_.ms;
+            snap.tracks = tracks_.tracks;
+            snap.samples = tracks_.samples;
+        }
+        res.set_content(tracksJson(snap, id, band, n), "application/json");
+    });
+
+    // GET /checkpoint — the trackers' next serials and the last position of
+    // every published track (see checkpointJson), the same state the frame
+    // loop carries across pipeline restarts. Pushed only while someone asks,
+    // like /tracks.
+    svr.Get("/checkpoint", [this](const httplib::Request&, httplib::Response& res) {
+        res.set_header("Cache-Control", "no-cache");
+        res.set_header("Access-Control-Allow-Origin", "*");
+        bool fresh = checkpointWanted();
+        checkpointPollMs_ = steadyMs();
+        thread_local TrackerCheckpoint cp;
+        {
+            std::unique_lock<std::mutex> lock(frameMtx_);
+            if (!fresh) {
+                int seq = checkpointSeq_;
+                checkpointCv_.wait_for(lock, std::chrono::milliseconds(500),
+                    [&] { return checkpointSeq_ != seq || !running_; });
+            }
+            if (checkpointSeq_ == 0) { res.status = 204; return; }
+            cp = checkpoint_;
+        }
+        res.set_content(checkpointJson(cp), "application/json");
+    });
+
+    // GET /gestures.bin — gestures after ?seq=N (see blobjson.hpp), long-polls
+    // until there is one; without seq only new gestures are returned.
+    svr.Get("/gestures.bin", [this](const httplib::Request& req, httplib::Response& res) {
+        res.set_header("Cache-Control", "no-cache");
+        res.set_header("Access-Control-Allow-Origin", "*");
+        thread_local std::vector<GestureEvent> events;
+        events.clear();
+        int firstSeq;
+        {
+            std::unique_lock<std::mutex> lock(frameMtx_);
+            int clientSeq = req.has_param("seq") ? std::stoi(req.get_param_value("seq")) : gestureSeq_;
+            blobsCv_.wait_for(lock, std::chrono::seconds(2),
+                [&] { return gestureSeq_ > clientSeq || !running_; });
+            if (clientSeq > gestureSeq_) clientSeq = gestureSeq_;   // server restarted numbering
+            if (gestureSeq_ - clientSeq > kGestureRing) clientSeq = gestureSeq_ - kGestureRing;
+            firstSeq = clientSeq + 1;
+            for (int s = firstSeq; s <= gestureSeq_; s++) events.push_back(gestureRing_[(s - 1) % kGestureRing]);
+        }
+        res.set_content(gesturesBinary(events, firstSeq), "application/octet-stream");
+    });
+
+    // GET /blobs.bin — binary blob frame (see blobjson.hpp); long-polls like depth.raw
+    svr.Get("/blobs.bin", [this](const httplib::Request& req, httplib::Response& res) {
+        res.set_header("Cache-Control", "no-cache");
+        res.set_header("Access-Control-Allow-Origin", "*");
+        int clientSeq = 0;
+        if (req.has_param("seq")) clientSeq = std::stoi(req.get_param_value("seq"));
+        {
+            std::unique_lock<std::mutex> lock(frameMtx_);
+            blobsCv_.wait_for(lock, std::chrono::seconds(2),
+                [&] { return blobsSeq_ > clientSeq || !running_; });
+        }
+        std::string body;
+        {
+            std::lock_guard<std::mutex> lock(frameMtx_);
+            if (blobsBin_.size() < kBlobBinHeaderSize) { res.status = 204; return; }
+            body = blobsBin_;
+            putU32(body, 4, static_cast<uint32_t>(blobsSeq_));
+        }
+        res.set_content(body, "application/octet-stream");
+    });
+
     // GET /events — Server-Sent Events for blob positions
+    // Gestures go out as "event: gesture" messages ahead of the blob frame.
     svr.Get("/events", [this](const httplib::Request&, httplib::Response& res) {
         res.set_header("Cache-Control", "no-cache");
         res.set_header("Connection", "keep-alive");
+        int lastGesture;
+        {
+            std::lock_guard<std::mutex> lock(frameMtx_);
+            lastGesture = gestureSeq_;
+        }
         res.set_chunked_content_provider(
             "text/event-stream",
-            [this](size_t, httplib::DataSink& sink) {
+            [this, lastGesture](size_t, httplib::DataSink& sink) mutable {
                 int lastSeq;
                 {
                     std::lock_guard<std::mutex> lock(frameMtx_);
@@ -2152,15 +2669,19 @@ void WebServer::run() {
                 {
                     std::unique_lock<std::mutex> lock(frameMtx_);
                     blobsCv_.wait_for(lock, std::chrono::seconds(2),
-                        [&] { return blobsSeq_ != lastSeq || !running_; });
+                        [&] { return blobsSeq_ != lastSeq || gestureSeq_ != lastGesture || !running_; });
                 }
                 if (!running_) return false;
-                std::string json;
+                std::string json, msg;
                 {
                     std::lock_guard<std::mutex> lock(frameMtx_);
                     json = blobsJson_;
+                    if (gestureSeq_ - lastGesture > kGestureRing) lastGesture = gestureSeq_ - kGestureRing;
+                    for (int s = lastGesture + 1; s <= gestureSeq_; s++)
+                        msg += "event: gesture\ndata: " + gestureJson(gestureRing_[(s - 1) % kGestureRing], s) + "\n\n";
+                    lastGesture = gestureSeq_;
                 }
-                std::string msg = "data: " + json + "\n\n";
+                msg += "data: " + json + "\n\n";
                 sink.write(msg.data(), msg.size());
                 return true;
             });
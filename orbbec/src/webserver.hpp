@@ -9,6 +9,12 @@
 #include <utility>
 #include <vector>
 
+#include "intrinsics.hpp"
+#include "gestures.hpp"
+#include "pipeline_settings.hpp"
+#include "trackerstate.hpp"
+#include "trajectory.hpp"
+
 // Minimal post-processing settings for Orbbec (filters will be added later)
 struct PostProcSettings {
     bool thresholdFilterEnable = true;
@@ -157,7 +163,28 @@ public:
     // Update the shared frame buffers (called from the main/camera thread).
     void updateColorFrame(const uint8_t* bgr, int width, int height);
     void updateDepthFrame(const uint8_t* bgr, int width, int height);
-    void updateBlobs(const std::string& json);
+    void updateBlobs(const std::string& json, const std::string& binary = {});
+
+    // Point cloud source for /pointcloud: raw depth (mm), the foreground mask
+    // (one byte per pixel, nonzero = foreground, see foregroundMask), the intrinsics to deproject with and, when depth and
+    // color are registered, the color of each depth pixel (BGR). Only worth
+    // pushing while pointCloudWanted(), i.e. a client polled in the last 2 s.
+    bool pointCloudWanted() const;
+    void updatePointCloud(const uint16_t* depthMm, const uint8_t* mask, int width, int height,
+                          const CameraIntrinsics& k, const uint8_t* colorBgr = nullptr);
+
+    // Gestures recognized by the trackers this frame (call before updateBlobs).
+    // They are numbered and kept in a small ring for /gestures.bin and /events.
+    void pushGestures(const std::vector<GestureEvent>& events);
+
+    // Track histories for /tracks (copied; the frame loop reuses its snapshot).
+    // Only worth pushing while tracksWanted(), i.e. a client asked in the last 2 s.
+    bool tracksWanted() const;
+    void updateTracks(const TrackHistorySnapshot& snap);
+
+    // Tracker state for /checkpoint (copied), pushed while checkpointWanted().
+    bool checkpointWanted() const;
+    void updateCheckpoint(const TrackerCheckpoint& cp);
 
     // Read current post-processing settings (thread-safe copy).
     PostProcSettings getPostProcSettings();
@@ -166,6 +193,15 @@ public:
     DeviceSettings getDeviceSettings();
     void setDeviceCaps(const DeviceCaps& caps);
 
+    // Software pipeline settings (ROI etc.), thread-safe copy. The sequence
+    // number increments on every change so the frame loop can poll it cheaply.
+    PipelineSettings getPipelineSettings();
+    int pipelineSettingsSeq() const { return pipelineSeq_.load(); }
+
+    // Surface plane status (JSON from PlaneEstimator::json) and refit requests.
+    void updatePlaneStatus(const std::string& json);
+    bool takePlaneRefitRequest() { return planeRefit_.exchange(false); }
+
     // Load settings from settings.json (call before start()).
     void loadSettings();
 
@@ -200,6 +236,7 @@ private:
     int depthH_ = 0;
 
     std::string blobsJson_;
+    std::string blobsBin_;          // binary blob frame for /blobs.bin
     std::condition_variable blobsCv_;
     int blobsSeq_ = 0;
 
@@ -208,6 +245,28 @@ private:
     std::condition_variable colorCv_;
     int colorSeq_ = 0;
 
+    std::vector<uint16_t> cloudDepth_;     // point cloud source, guarded by frameMtx_
+    std::vector<uint8_t> cloudMask_;       // 1 = foreground
+    std::vector<uint8_t> cloudColor_;      // registered color, empty = unregistered
+    CameraIntrinsics cloudIntr_;
+    std::condition_variable cloudCv_;
+    int cloudSeq_ = 0;
+    std::atomic<long long> cloudPollMs_{-1000000};   // last /pointcloud request (steady ms)
+
+    TrackHistorySnapshot tracks_;          // guarded by frameMtx_
+    std::condition_variable tracksCv_;
+    int tracksSeq_ = 0;
+    std::atomic<long long> tracksPollMs_{-1000000};  // last /tracks request (steady ms)
+
+    TrackerCheckpoint checkpoint_;         // guarded by frameMtx_
+    std::condition_variable checkpointCv_;
+    int checkpointSeq_ = 0;
+    std::atomic<long long> checkpointPollMs_{-1000000};  // last /checkpoint request (steady ms)
+
+    static constexpr int kGestureRing = 64;
+    GestureEvent gestureRing_[kGestureRing];   // event seq s at (s - 1) % kGestureRing
+    int gestureSeq_ = 0;                        // events so far, guarded by frameMtx_
+
     std::mutex postProcMtx_;
     PostProcSettings postProc_;
 
@@ -215,6 +274,12 @@ private:
     DeviceSettings devSettings_;
     DeviceCaps devCaps_;
 
+    std::mutex pipelineMtx_;
+    PipelineSettings pipeline_;
+    std::atomic<int> pipelineSeq_{0};
+    std::string planeStatus_ = "{\"valid\":false}";   // guarded by pipelineMtx_
+    std::atomic<bool> planeRefit_{false};
+
     // Sound / UI settings (persisted to settings.json)
     std::atomic<int> soundMode_{0};
     std::atomic<int> soundKey_{0};